@@ -0,0 +1,128 @@
+#ifndef AUTOMATON_H
+#define AUTOMATON_H
+/*
+ * 文件名:Automaton.h
+ * 摘要：NFA DFA SDFA 共用的紧凑存储
+ *
+ * 状态连续存放，出边按压缩稀疏行 (CSR) 形式存放在一个数组中，
+ * 空边单独存放在另一个邻接数组中。每个状态只占几个整数，遍历出边就是线性扫描。
+*/
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "BaseXFA.h"
+using namespace std;
+
+// 一条压缩存储的出边
+struct FlatEdge {
+    uint32_t tail;  // 尾部指向的 stateID
+    uint32_t sym;   // 边上的值在 SymbolTable 中的 id
+};
+
+// 连续数组中的一段，可以直接用于范围 for
+template<class T>
+struct Range {
+    const T* b;
+    const T* e;
+    const T* begin() const { return b; }
+    const T* end() const { return e; }
+    size_t size() const { return e - b; }
+    bool empty() const { return b == e; }
+};
+
+class Automaton {
+private:
+    vector<uint32_t> edgeBegin;  // 状态 s 的出边为 edges[edgeBegin[s], edgeBegin[s+1])
+    vector<FlatEdge> edges;
+    vector<uint32_t> epBegin;    // 状态 s 的空边为 epTail[epBegin[s], epBegin[s+1])
+    vector<uint32_t> epTail;
+    vector<int32_t> accept;      // 终态对应的规则序号（越小越优先），非终态为 -1
+    size_t start;                // 初态
+public:
+    Automaton() : edgeBegin(1, 0), epBegin(1, 0), start(0) {}
+
+    void clear() {
+        vector<uint32_t>(1, 0).swap(edgeBegin);
+        vector<FlatEdge>().swap(edges);
+        vector<uint32_t>(1, 0).swap(epBegin);
+        vector<uint32_t>().swap(epTail);
+        vector<int32_t>().swap(accept);
+        start = 0;
+    }
+
+    /**
+     * @brief 由任意顺序的边表一次性构造（用于 Thompson 构造得到的 NFA）
+     * @param _accept 每个状态的规则序号，非终态为 -1
+     * @param edgeList 边表，epsilon 边放入空边数组，其余放入出边数组
+     * @param _start 初态
+     * @note 按头部状态计数排序，同一状态的边保持原来的先后顺序
+     */
+    void assign(const vector<int32_t>& _accept, const vector<Edge>& edgeList, size_t _start) {
+        size_t n = _accept.size();
+        accept = _accept;
+        start = _start;
+        edgeBegin.assign(n + 1, 0);
+        epBegin.assign(n + 1, 0);
+        for (auto & e : edgeList)
+            (e.sym == EPSILON_ID ? epBegin : edgeBegin)[e.head + 1]++;
+        for (size_t i = 0; i < n; i++) {
+            edgeBegin[i + 1] += edgeBegin[i];
+            epBegin[i + 1] += epBegin[i];
+        }
+        edges.assign(edgeBegin[n], FlatEdge());
+        epTail.assign(epBegin[n], 0);
+        vector<uint32_t> edgeFill(edgeBegin.begin(), edgeBegin.end() - 1);
+        vector<uint32_t> epFill(epBegin.begin(), epBegin.end() - 1);
+        for (auto & e : edgeList) {
+            if (e.sym == EPSILON_ID)
+                epTail[epFill[e.head]++] = uint32_t(e.tail);
+            else {
+                FlatEdge fe = {uint32_t(e.tail), uint32_t(e.sym)};
+                edges[edgeFill[e.head]++] = fe;
+            }
+        }
+    }
+
+    // 按编号顺序追加一个状态，返回它的 id；之后的 addEdge 都加在这个状态上
+    size_t addState(int32_t _accept = -1) {
+        accept.push_back(_accept);
+        edgeBegin.push_back(edgeBegin.back());
+        epBegin.push_back(epBegin.back());
+        return accept.size() - 1;
+    }
+    void addEdge(size_t sym, size_t tail) {
+        FlatEdge fe = {uint32_t(tail), uint32_t(sym)};
+        edges.push_back(fe);
+        edgeBegin.back() = uint32_t(edges.size());
+    }
+    void setStart(size_t s) { start = s; }
+    void setAccept(size_t s, int32_t rule) { accept[s] = rule; }
+    void shrink() {
+        edgeBegin.shrink_to_fit();
+        edges.shrink_to_fit();
+        epBegin.shrink_to_fit();
+        epTail.shrink_to_fit();
+        accept.shrink_to_fit();
+    }
+
+    size_t size() const { return accept.size(); }
+    bool empty() const { return accept.empty(); }
+    size_t getStart() const { return start; }
+    int32_t getAccept(size_t s) const { return accept[s]; }
+    bool isEnd(size_t s) const { return accept[s] >= 0; }
+    size_t edgeCount() const { return edges.size() + epTail.size(); }
+    Range<FlatEdge> getEdges(size_t s) const {
+        Range<FlatEdge> r = {edges.data() + edgeBegin[s], edges.data() + edgeBegin[s + 1]};
+        return r;
+    }
+    Range<uint32_t> getEpEdges(size_t s) const {
+        Range<uint32_t> r = {epTail.data() + epBegin[s], epTail.data() + epBegin[s + 1]};
+        return r;
+    }
+    // 占用的字节数，用于比较存储开销
+    size_t memoryBytes() const {
+        return (edgeBegin.capacity() + epBegin.capacity() + epTail.capacity()) * sizeof(uint32_t)
+                + edges.capacity() * sizeof(FlatEdge) + accept.capacity() * sizeof(int32_t);
+    }
+};
+#endif // AUTOMATON_H
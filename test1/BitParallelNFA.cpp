@@ -0,0 +1,156 @@
+#include "BitParallelNFA.h"
+const uint32_t BitParallelNFA::DEAD;
+const size_t BitParallelNFA::MAX_WORDS;
+/**
+ * @brief 构造位并行 NFA 模拟器
+ * @param _lex DFA 超出预算后的词法分析器，需要已经计算好 Glushkov 位置或 NFA 的空边闭包
+ * @note Glushkov 位置数不超过 MAX_WORDS * 64 时使用位并行：
+ * 预先为每个转移字符、AnyChar 和结束标记建立位置掩码，
+ * 并把位置集合按字节切分，为每个字节的 256 种取值预先求出 followpos 之并，
+ * 一步转移只需要按字节查表再按字相或。否则在 Thompson NFA 上模拟。
+ */
+BitParallelNFA::BitParallelNFA(const WordAnal& _lex)
+    : lex(_lex), anySym(SymbolTable::instance().find("AnyChar")), glushkov(false), nWords(0) {
+    const vector<size_t>& rankSym = lex.getRankSym();
+    classRanks.assign(lex.getClassCount(), {});
+    for (size_t r = 0; r < rankSym.size(); r++)
+        if (rankSym[r] != anySym)
+            for (auto c : lex.getSymClasses()[rankSym[r]])
+                classRanks[c].push_back(r);
+
+    const vector<size_t>& posSym = lex.getPosSym();
+    size_t n = posSym.size();
+    glushkov = n > 0 && lex.getFollowPos().size() == n && n <= MAX_WORDS * 64;
+    if (!glushkov) {
+        nfaSets[0] = lex.getEpClosure(0);
+        acc[0] = -1;
+        for (auto p : nfaSets[0]) {
+            int32_t r = lex.getNFAgraph().getAccept(p);
+            if (r >= 0 && (acc[0] < 0 || r < acc[0]))
+                acc[0] = r;
+        }
+        return;
+    }
+
+    nWords = (n + 63) / 64;
+    const vector<size_t>& symRank = lex.getSymRank();
+    rankMask.assign(rankSym.size() * nWords, 0);
+    anyMask.assign(nWords, 0);
+    endMask.assign(nWords, 0);
+    for (size_t p = 0; p < n; p++) {
+        uint64_t bit = uint64_t(1) << (p & 63);
+        if (lex.getPosRule()[p] >= 0)
+            endMask[p >> 6] |= bit;
+        else if (posSym[p] == anySym)
+            anyMask[p >> 6] |= bit;
+        else if (posSym[p] < symRank.size() && symRank[posSym[p]] != NO_EDGE)
+            rankMask[symRank[posSym[p]] * nWords + (p >> 6)] |= bit;
+    }
+    // 按字节查表：b 的 followpos 之并 = 去掉最低位后的结果 | 最低位对应位置的 followpos
+    followTable.assign(nWords * 8 * 256 * nWords, 0);
+    for (size_t k = 0; k < nWords * 8; k++)
+        for (size_t b = 1; b < 256; b++) {
+            uint64_t* dst = &followTable[(k * 256 + b) * nWords];
+            const uint64_t* rest = &followTable[(k * 256 + (b & (b - 1))) * nWords];
+            for (size_t w = 0; w < nWords; w++)
+                dst[w] = rest[w];
+            size_t p = k * 8 + lowestBit(b);
+            if (p < n)
+                for (auto q : lex.getFollowPos()[p])
+                    dst[q >> 6] |= uint64_t(1) << (q & 63);
+        }
+    sets.assign(3 * nWords, 0);
+    acc[0] = -1;
+    for (auto p : lex.getFirstPos()) {
+        sets[p >> 6] |= uint64_t(1) << (p & 63);
+        if (lex.getPosRule()[p] >= 0 && (acc[0] < 0 || lex.getPosRule()[p] < acc[0]))
+            acc[0] = lex.getPosRule()[p];
+    }
+}
+
+/**
+ * @brief Glushkov 位并行的一步：把集合 s 与 mask 的交集中各个位置的 followpos 之并放入另一个集合
+ * @return 下一个集合，为空返回 DEAD
+ * @note 结束标记按规则顺序编号，所以下一集合中编号最小的结束标记就是优先级最高的规则
+ */
+uint32_t BitParallelNFA::follow(uint32_t s, const uint64_t* mask) {
+    uint32_t d = other(s);
+    const uint64_t* src = &sets[s * nWords];
+    uint64_t* dst = &sets[d * nWords];
+    uint64_t any = 0;
+    for (size_t w = 0; w < nWords; w++)
+        dst[w] = 0;
+    for (size_t w = 0; w < nWords; w++) {
+        uint64_t x = src[w] & mask[w];
+        for (size_t k = 0; x; k++, x >>= 8)
+            if (x & 0xFF) {
+                const uint64_t* row = &followTable[((w * 8 + k) * 256 + (x & 0xFF)) * nWords];
+                for (size_t v = 0; v < nWords; v++)
+                    dst[v] |= row[v];
+            }
+    }
+    acc[d] = -1;
+    for (size_t w = 0; w < nWords; w++) {
+        any |= dst[w];
+        uint64_t e = dst[w] & endMask[w];
+        if (e && acc[d] < 0)
+            acc[d] = lex.getPosRule()[w * 64 + lowestBit(e)];
+    }
+    return any ? d : DEAD;
+}
+
+/**
+ * @brief Thompson NFA 模拟的一步：集合 s 中符号为 sym 的出边到达的状态的空边闭包之并
+ * @return 下一个集合，为空返回 DEAD
+ */
+uint32_t BitParallelNFA::nfaMove(uint32_t s, size_t sym) {
+    const Automaton& nfa = lex.getNFAgraph();
+    uint32_t d = other(s);
+    StateSet& next = nfaSets[d];
+    next.clear();
+    for (auto p : nfaSets[s])
+        for (auto & edge : nfa.getEdges(p))
+            if (edge.sym == sym)
+                next.unite(lex.getEpClosure(edge.tail));
+    if (next.empty())
+        return DEAD;
+    acc[d] = -1;
+    for (auto p : next) {
+        int32_t r = nfa.getAccept(p);
+        if (r >= 0 && (acc[d] < 0 || r < acc[d]))
+            acc[d] = r;
+    }
+    return d;
+}
+
+/**
+ * @brief 显式的出边：按转移字符的顺序，取第一个在当前集合中出现并且能匹配 ch 的转移字符
+ * @note 与 DFA 中按 transChar 顺序排列的出边、生成程序中的 if / else if 顺序一致
+ */
+uint32_t BitParallelNFA::step(uint32_t s, unsigned char ch) {
+    const vector<size_t>& ranks = classRanks[lex.getCharClass()[ch]];
+    if (glushkov) {
+        for (auto r : ranks) {
+            const uint64_t* mask = &rankMask[r * nWords];
+            for (size_t w = 0; w < nWords; w++)
+                if (sets[s * nWords + w] & mask[w])
+                    return follow(s, mask);
+        }
+        return DEAD;
+    }
+    const vector<size_t>& symRank = lex.getSymRank();
+    size_t best = NO_EDGE;
+    for (auto p : nfaSets[s])
+        for (auto & edge : lex.getNFAgraph().getEdges(p)) {
+            size_t r = edge.sym < symRank.size() ? symRank[edge.sym] : NO_EDGE;
+            if (r != NO_EDGE && r < best && find(ranks.begin(), ranks.end(), r) != ranks.end())
+                best = r;
+        }
+    return best == NO_EDGE ? DEAD : nfaMove(s, lex.getRankSym()[best]);
+}
+
+uint32_t BitParallelNFA::stepAny(uint32_t s) {
+    if (anySym == NO_EDGE)
+        return DEAD;
+    return glushkov ? follow(s, anyMask.data()) : nfaMove(s, anySym);
+}
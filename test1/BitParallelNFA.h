@@ -0,0 +1,48 @@
+#ifndef BITPARALLELNFA_H
+#define BITPARALLELNFA_H
+/*
+ * 文件名:BitParallelNFA.h
+ * 摘要：不构造 DFA，直接用位向量模拟 NFA 进行词法分析
+ *
+ * DFA 超出状态数或内存预算时使用，占用的内存与 NFA 的大小成正比。
+ * Glushkov 位置数不超过 MAX_WORDS 个 64 位字时，按字节查表求 followpos 之并（位并行）；
+ * 否则在 Thompson NFA 上模拟，状态集合为 StateSet 位向量。
+*/
+#include "WordAnal.h"
+#include "LexRuntime.h"
+
+class BitParallelNFA {
+public:
+    static const uint32_t DEAD = UINT32_MAX - 1;    // 没有转移
+    static const size_t MAX_WORDS = 4;              // 位并行时位置集合最多占用的字数
+private:
+    const WordAnal& lex;        // 提供 NFA、Glushkov 位置和字符等价类，使用期间不能重新解析
+    size_t anySym;              // AnyChar 的符号 id，没有为 NO_EDGE
+    vector<vector<size_t>> classRanks;  // 每个等价类能匹配的转移字符序号，从小到大，不含 AnyChar
+    bool glushkov;              // 是否使用 Glushkov 位并行
+    int32_t acc[3];             // 三个集合各自的规则序号：0 号为初态，1、2 号轮流作为当前状态和下一状态
+
+    // Glushkov 位并行，集合为 nWords 个 64 位字
+    size_t nWords;
+    vector<uint64_t> sets;          // sets[s * nWords + w]
+    vector<uint64_t> rankMask;      // rankMask[r * nWords + w]：符号序号为 r 的位置
+    vector<uint64_t> anyMask;       // 符号为 AnyChar 的位置
+    vector<uint64_t> endMask;       // 规则的结束标记
+    vector<uint64_t> followTable;   // followTable[(k * 256 + b) * nWords + w]：第 k 个字节为 b 时这些位置的 followpos 之并
+
+    // Thompson NFA 模拟
+    StateSet nfaSets[3];
+
+    uint32_t other(uint32_t s) const { return s == 1 ? 2 : 1; }
+    uint32_t follow(uint32_t s, const uint64_t* mask);
+    uint32_t nfaMove(uint32_t s, size_t sym);
+public:
+    explicit BitParallelNFA(const WordAnal& _lex);
+    bool isGlushkov() const { return glushkov; }
+
+    uint32_t start() const { return 0; }
+    uint32_t step(uint32_t s, unsigned char ch);
+    uint32_t stepAny(uint32_t s);
+    int32_t accept(uint32_t s) const { return acc[s]; }
+};
+#endif // BITPARALLELNFA_H
@@ -1,206 +1,299 @@
-#include "GramAnal.h"
-
-// 主控程序
-// 需要先调用 parseStrToGrammar 函数，得到对应的 grammars
-bool GramAnal::Run(WindowState state, const QString tokenStr) {
-    rmHarmfulProd();
-    rmNoArriveGram();
-    rmNoStopGram();
-    if(state == GrammarSimplify)
-        return true;
-
-    rmLeftRecursive();
-    if(state == removeLeftRecursive)
-        return true;
-
-    rmLeftCommonFactor();
-    if(state == removeLeftCommonFactor)
-        return true;
-
-    genFirst();
-    genFollow();
-    if(state == FirstFollow)
-        return true;
-
-    genLLtable();
-    if(state == LLtable)
-        return true;
-
-    if(!setTokens(tokenStr))  // 设置 词法分析结果 失败，返回 false
-        return false;
-
-    LL1();
-    if(state == GrammarTree)
-        return true;
-    return true;
-}
-GramAnal::GramAnal() {
-    root = nullptr;
-}
-
-GramAnal::~GramAnal() {
-    clearArg();
-}
-
-void GramAnal::clearArg() {
-    firstNonterm = "";
-    grammars.clear();
-    Terms.clear();
-    AnalyTable.clear();
-    order.clear();
-    tokens.clear();
-}
-
-
-/**
- * @brief 设置语法分析器的 token
- * @param strToken: 包含 token 的字符串，每行格式为 "token_type\ttoken_value"
- * @return 设置成功返回 true，否则返回 false
- * @details 该函数将字符串 strToken 解析成一组 token，并存储在类成员变量 tokens 中
- *          如果输入格式不正确，函数会输出错误信息并返回 false
- */
-bool GramAnal::setTokens(const QString strToken)
-{
-    QStringList lines = strToken.split("\n"); // 按行分割字符串
-    for(const auto& line : lines){
-        QStringList section = line.split("\t",QString::SkipEmptyParts); // 按制表符分割每行字符串
-        if(section.size()== 0){
-            qWarning() << "ERROR from setTokens(): this line size is 0!!!" << section;
-        }
-        else if(section.size()!= 2){ // 如果分割结果不正确，输出错误信息并返回 false
-            qWarning() << "ERROR from setTokens(): this line is more than 2!!!" << section;
-            return false;
-        }else{
-            tokens.push_back({section[1],section[0]}); // 将 token 加入列表
-        }
-    }
-    return true; // 返回设置成功
-}
-QString GramAnal::toGramString(const QString &Vn) const {
-    QStringList prods;
-    for (const auto& prod : grammars[Vn].right)
-        prods << prod.join(" "); // symbol 中间添加 空格
-    return QString("%1 -> %2").arg(Vn).arg(prods.join(" | ")); // prod 中间添加 |
-}
-
-/**
- * @brief 更新文法中的终结符集合和非终结符集合
- */
-void GramAnal::updateGrammars(const QSet<QString>& removeVn) {
-    if(removeVn.empty())
-        return;
-//    debugGram("Before updateGrammars: ");
-    QSet<QString> checkVn = {""};      // 检查非终结符 可能需要删除
-    QSet<QString> checkVt;              // 检查终结符   可能需要删除
-    QSet<QString> clearedVn = removeVn; // 非终结符     必须删除
-    QSet<QString> clearVt;              // 终结符       必须删除,在 check确认后 增加
-
-    while(checkVt.size() || checkVn.size()){
-        // 获取所有 需要检查的 Vn 和 Vt
-        checkVt.clear();
-        checkVn.clear();
-        for(const auto& ckVn: clearedVn)
-            if(grammars.contains(ckVn))
-                for(const auto& prod: grammars[ckVn].right)
-                    for(const auto& symbol : prod) { // 遍历所有 需要删除文法含有的 符号，添加到check集合
-                        if(isNonTerm(symbol) && !clearedVn.contains(symbol) && symbol != firstNonterm) {
-                            checkVn.insert(symbol);
-                        }else if (isTerm(symbol) && !clearVt.contains(symbol)) {
-                            checkVt.insert(symbol);
-                        }
-                    }
-        if(checkVt.empty() && checkVn.empty())
-            break;
-
-        // 遍历其他 grammar 删除含有Vn的产生式， 以及含有的 Vt 从检查集合移除
-        for(auto& leftVn: grammars.keys()) {
-            if(clearedVn.contains(leftVn)) { // 如果是 将要被删除的 非终结符 ，跳过
-                continue;
-            } else {
-                QSet<QStringList> newRight;
-                for(auto& prod: grammars[leftVn].right) {
-                    bool flgRmProd = false;  // 判断是否 含有clearedVn 的产生式，
-                    //   当 checkVn 元素出现在其他的 prod 里面
-                    for(const auto& symbol: prod)
-                        if(clearedVn.contains(symbol)) {
-                            flgRmProd = true;
-                            break;
-                        }
-                    if(!flgRmProd)
-                        newRight.insert(prod);
-                } // producer
-                if(newRight.size()!=0){ // 如果删除后的结果不为空
-                    grammars[leftVn].right = newRight;
-                    for(const auto& prod: newRight)
-                        for(const auto& symbol: prod){
-                            checkVt.remove(symbol);  // 终结符 在其他 gram 出现，不需要删除
-                            if(!clearedVn.contains(symbol)){
-                                checkVn.remove(symbol);  // 不是必须删除的非终结符 在其他 gram 出现，不需要删除
-                            }
-                        }
-                } else { // 如果删除后,得到的右部为空
-                    clearedVn.insert(leftVn);
-                    checkVn.insert(leftVn);
-                }
-            }
-        }// gram
-        for(const auto& Vt:checkVt)
-            clearVt.insert(Vt);
-    }// end while
-
-    for(const auto& Vn:clearedVn)
-        grammars.remove(Vn); // 删除非终结符左部
-    for(const auto& Vt: clearVt)
-        Terms.remove(Vt);
-    debugGram("After updateGrammars: ");
-}
-/**
- * @brief 将字符串形式的文法转换为内部数据结构
- *
- * @param QString str 输入的字符串形式的文法
- * @return bool true 转换成功，false 转换失败
- * @note
- * 该函数会解析输入的字符串，将产生式左部和右部分别提取出来，
- * 并将符号添加到终结符集合和语法规则中，
- * 来实现将字符串形式的文法转换为内部数据结构的过程。
- */
-bool GramAnal::parseStrToGrammar(const QString& str) {
-    if(str == "")
-        return false;
-    clearArg();  // 初始化成员变量
-    QStringList lines = str.split("\n", QString::SkipEmptyParts); // 跳过空行
-    for(const auto& line: lines){
-        QStringList parts = line.split("->");
-        if (parts.size() != 2){
-            return false; // 含有错误产生式：产生式不符合 -> 格式 或者 存在多个，返回错误
-        }
-        QString left = parts[0].trimmed();// 左部非终结符
-        grammars[left] = {};        // 初始化 grammar
-    }
-
-    for (const auto& line : lines) {
-        QStringList parts = line.split("->");
-        QString left = parts[0].trimmed();// 左部非终结符
-        QStringList prods = parts[1].split("|");// 右部产生式
-        QSet<QStringList> newRight;
-        for (const auto& prod : prods) {
-            QStringList symbols = prod.trimmed().split(" ",QString::SkipEmptyParts); // 右部符号序列
-//            qDebug() << symbols;
-            newRight.insert(symbols);
-            for (const auto& symbol : symbols) { // 遍历所有符号
-                if (!isNonTerm(symbol) && !isTerm(symbol) && symbol != epsilon) // 如果没有记录过 且不是 空串
-                    Terms.insert(symbol);// 将右部中未出现过的符号添加到终结符集合中
-            }
-        }
-        // 得到的语法添加到grammars
-        if(grammars.contains(left)){
-            for(const auto& r: newRight)
-                grammars[left].right.insert(r);
-        } else
-            grammars[left].right = newRight;
-
-        if(firstNonterm == "")
-            firstNonterm = left;// 默认第一个就是文法开始符号
-    }
-    return true;
-}
+#include "GramAnal.h"
+
+// 主控程序
+// 需要先调用 parseStrToGrammar 函数，得到对应的 grammars
+bool GramAnal::Run(WindowState state, const QString tokenStr) {
+    if(buildTable(state))   // 不需要进行 LL1 分析
+        return true;
+
+    if(!setTokens(tokenStr))  // 设置 词法分析结果 失败，返回 false
+        return false;
+
+    LL1();
+    return true;
+}
+
+// 主控程序，词法分析的结果直接以记号数组给出，不经过文本
+bool GramAnal::Run(WindowState state, const vector<Token>& tokenList) {
+    if(buildTable(state))
+        return true;
+
+    setTokens(tokenList);
+    LL1();
+    return true;
+}
+
+// 主控程序，词法分析的结果为二进制单词流文件，映射到内存后直接读记号
+bool GramAnal::RunTokenStream(WindowState state, const QString& path) {
+    if(buildTable(state))
+        return true;
+
+    if(!setTokenStream(path))
+        return false;
+    LL1();
+    return true;
+}
+
+// 化简文法、消除左递归和左公因子、求 First Follow 集和 LL1 分析表，state 在 LL1 分析之前就已完成时返回 true
+bool GramAnal::buildTable(WindowState state) {
+    rmHarmfulProd();
+    rmNoArriveGram();
+    rmNoStopGram();
+    if(state == GrammarSimplify)
+        return true;
+
+    rmLeftRecursive();
+    if(state == removeLeftRecursive)
+        return true;
+
+    rmLeftCommonFactor();
+    if(state == removeLeftCommonFactor)
+        return true;
+
+    genFirst();
+    genFollow();
+    if(state == FirstFollow)
+        return true;
+
+    genLLtable();
+    if(state == LLtable)
+        return true;
+    return false;
+}
+GramAnal::GramAnal() {
+    root = nullptr;
+    tokenIndex = 0;
+}
+
+GramAnal::~GramAnal() {
+    clearArg();
+}
+
+void GramAnal::clearArg() {
+    firstNonterm = "";
+    grammars.clear();
+    Terms.clear();
+    AnalyTable.clear();
+    order.clear();
+    tokens.clear();
+    tokenStream.close();
+    streamKinds.clear();
+    tokenFile.close();  // 同时解除映射
+}
+
+
+/**
+ * @brief 设置语法分析器的 token
+ * @param strToken: 包含 token 的字符串，每行格式为 "token_value\ttoken_type"，
+ *                  生成的程序用 -l 选项时每行后面还有 "\t行号:列号"
+ * @return 设置成功返回 true，否则返回 false
+ * @details 该函数将字符串 strToken 解析成一组 token，并存储在类成员变量 tokens 中
+ *          如果输入格式不正确，函数会输出错误信息并返回 false；没有行号和列号时记号的位置为 0
+ */
+bool GramAnal::setTokens(const QString strToken)
+{
+    QStringList lines = strToken.split("\n"); // 按行分割字符串
+    for(const auto& line : lines){
+        QStringList section = line.split("\t",QString::SkipEmptyParts); // 按制表符分割每行字符串
+        if(section.size()== 0){
+            qWarning() << "ERROR from setTokens(): this line size is 0!!!" << section;
+        }
+        else if(section.size()!= 2 && section.size() != 3){ // 如果分割结果不正确，输出错误信息并返回 false
+            qWarning() << "ERROR from setTokens(): this line is more than 3!!!" << section;
+            return false;
+        }else{
+            Token tok(section[1],section[0]);
+            if(section.size() == 3){    // 行号:列号
+                QStringList at = section[2].split(":");
+                tok.line = at[0].toULong();
+                tok.column = at.size() > 1 ? at[1].toULong() : 0;
+            }
+            tokens.push_back(tok); // 将 token 加入列表
+        }
+    }
+    return true; // 返回设置成功
+}
+
+// 设置语法分析器的 token，记号数组由进程内的词法分析直接给出
+void GramAnal::setTokens(const vector<Token>& tokenList) {
+    tokens.insert(tokens.end(), tokenList.begin(), tokenList.end());
+}
+
+/**
+ * @brief 设置语法分析器的 token：把二进制单词流文件（格式见 LexRuntime.h）映射到内存
+ * @param path 生成的程序的 -b / -B 选项或者 WordAnal::tokenStream 写出的文件
+ * @return 文件打不开、不能映射或者文件头不对时返回 false
+ * @details 不读入文件，也不生成 tokens 数组：LL1 通过 readToken 直接在映射的内存上逐条解码记录，
+ *          种别名在这里从字典中各转换一次，记号的文本在读到它时才从源文本中取出，
+ *          行号和列号由 streamLines 统计上一个记号到这个记号之间的换行符得到。文件一直映射到下一次 clearArg
+ */
+bool GramAnal::setTokenStream(const QString& path) {
+    tokenFile.setFileName(path);
+    if(!tokenFile.open(QIODevice::ReadOnly)){
+        qWarning() << "ERROR from setTokenStream(): can't open" << path;
+        return false;
+    }
+    const uchar* data = tokenFile.size() > 0 ? tokenFile.map(0, tokenFile.size()) : nullptr;
+    if(!data || !tokenStream.open(data, size_t(tokenFile.size()))){
+        qWarning() << "ERROR from setTokenStream(): not a token stream" << path;
+        tokenFile.close();
+        return false;
+    }
+    for(size_t kind = 0; kind < tokenStream.kindCount(); kind++){
+        size_t length;
+        const char* name = tokenStream.kindName(kind, length);
+        streamKinds.push_back(QString::fromUtf8(name, int(length)));
+    }
+    streamLines.reset(tokenStream.text());
+    return true;
+}
+
+// LL1 读入下一个记号：映射了单词流时解码下一条记录，否则取 tokens 中的下一个
+bool GramAnal::readToken(Token& tok) {
+    if(tokenFile.isOpen()){
+        LexToken rec;
+        if(!tokenStream.next(rec)){
+            if(tokenStream.index() < tokenStream.count())
+                qWarning() << "ERROR from readToken(): bad record" << tokenStream.index();
+            return false;
+        }
+        LexPosition at = streamLines.at(rec.offset);
+        tok.type = streamKinds[rec.kind];
+        tok.content = QString::fromUtf8(tokenStream.text() + rec.offset, int(rec.length));
+        tok.line = at.line;
+        tok.column = at.column;
+        return true;
+    }
+    if(tokenIndex >= tokens.size())
+        return false;
+    tok = tokens[tokenIndex++];
+    return true;
+}
+QString GramAnal::toGramString(const QString &Vn) const {
+    QStringList prods;
+    for (const auto& prod : grammars[Vn].right)
+        prods << prod.join(" "); // symbol 中间添加 空格
+    return QString("%1 -> %2").arg(Vn).arg(prods.join(" | ")); // prod 中间添加 |
+}
+
+/**
+ * @brief 更新文法中的终结符集合和非终结符集合
+ */
+void GramAnal::updateGrammars(const QSet<QString>& removeVn) {
+    if(removeVn.empty())
+        return;
+//    debugGram("Before updateGrammars: ");
+    QSet<QString> checkVn = {""};      // 检查非终结符 可能需要删除
+    QSet<QString> checkVt;              // 检查终结符   可能需要删除
+    QSet<QString> clearedVn = removeVn; // 非终结符     必须删除
+    QSet<QString> clearVt;              // 终结符       必须删除,在 check确认后 增加
+
+    while(checkVt.size() || checkVn.size()){
+        // 获取所有 需要检查的 Vn 和 Vt
+        checkVt.clear();
+        checkVn.clear();
+        for(const auto& ckVn: clearedVn)
+            if(grammars.contains(ckVn))
+                for(const auto& prod: grammars[ckVn].right)
+                    for(const auto& symbol : prod) { // 遍历所有 需要删除文法含有的 符号，添加到check集合
+                        if(isNonTerm(symbol) && !clearedVn.contains(symbol) && symbol != firstNonterm) {
+                            checkVn.insert(symbol);
+                        }else if (isTerm(symbol) && !clearVt.contains(symbol)) {
+                            checkVt.insert(symbol);
+                        }
+                    }
+        if(checkVt.empty() && checkVn.empty())
+            break;
+
+        // 遍历其他 grammar 删除含有Vn的产生式， 以及含有的 Vt 从检查集合移除
+        for(auto& leftVn: grammars.keys()) {
+            if(clearedVn.contains(leftVn)) { // 如果是 将要被删除的 非终结符 ，跳过
+                continue;
+            } else {
+                QSet<QStringList> newRight;
+                for(auto& prod: grammars[leftVn].right) {
+                    bool flgRmProd = false;  // 判断是否 含有clearedVn 的产生式，
+                    //   当 checkVn 元素出现在其他的 prod 里面
+                    for(const auto& symbol: prod)
+                        if(clearedVn.contains(symbol)) {
+                            flgRmProd = true;
+                            break;
+                        }
+                    if(!flgRmProd)
+                        newRight.insert(prod);
+                } // producer
+                if(newRight.size()!=0){ // 如果删除后的结果不为空
+                    grammars[leftVn].right = newRight;
+                    for(const auto& prod: newRight)
+                        for(const auto& symbol: prod){
+                            checkVt.remove(symbol);  // 终结符 在其他 gram 出现，不需要删除
+                            if(!clearedVn.contains(symbol)){
+                                checkVn.remove(symbol);  // 不是必须删除的非终结符 在其他 gram 出现，不需要删除
+                            }
+                        }
+                } else { // 如果删除后,得到的右部为空
+                    clearedVn.insert(leftVn);
+                    checkVn.insert(leftVn);
+                }
+            }
+        }// gram
+        for(const auto& Vt:checkVt)
+            clearVt.insert(Vt);
+    }// end while
+
+    for(const auto& Vn:clearedVn)
+        grammars.remove(Vn); // 删除非终结符左部
+    for(const auto& Vt: clearVt)
+        Terms.remove(Vt);
+    debugGram("After updateGrammars: ");
+}
+/**
+ * @brief 将字符串形式的文法转换为内部数据结构
+ *
+ * @param QString str 输入的字符串形式的文法
+ * @return bool true 转换成功，false 转换失败
+ * @note
+ * 该函数会解析输入的字符串，将产生式左部和右部分别提取出来，
+ * 并将符号添加到终结符集合和语法规则中，
+ * 来实现将字符串形式的文法转换为内部数据结构的过程。
+ */
+bool GramAnal::parseStrToGrammar(const QString& str) {
+    if(str == "")
+        return false;
+    clearArg();  // 初始化成员变量
+    QStringList lines = str.split("\n", QString::SkipEmptyParts); // 跳过空行
+    for(const auto& line: lines){
+        QStringList parts = line.split("->");
+        if (parts.size() != 2){
+            return false; // 含有错误产生式：产生式不符合 -> 格式 或者 存在多个，返回错误
+        }
+        QString left = parts[0].trimmed();// 左部非终结符
+        grammars[left] = {};        // 初始化 grammar
+    }
+
+    for (const auto& line : lines) {
+        QStringList parts = line.split("->");
+        QString left = parts[0].trimmed();// 左部非终结符
+        QStringList prods = parts[1].split("|");// 右部产生式
+        QSet<QStringList> newRight;
+        for (const auto& prod : prods) {
+            QStringList symbols = prod.trimmed().split(" ",QString::SkipEmptyParts); // 右部符号序列
+//            qDebug() << symbols;
+            newRight.insert(symbols);
+            for (const auto& symbol : symbols) { // 遍历所有符号
+                if (!isNonTerm(symbol) && !isTerm(symbol) && symbol != epsilon) // 如果没有记录过 且不是 空串
+                    Terms.insert(symbol);// 将右部中未出现过的符号添加到终结符集合中
+            }
+        }
+        // 得到的语法添加到grammars
+        if(grammars.contains(left)){
+            for(const auto& r: newRight)
+                grammars[left].right.insert(r);
+        } else
+            grammars[left].right = newRight;
+
+        if(firstNonterm == "")
+            firstNonterm = left;// 默认第一个就是文法开始符号
+    }
+    return true;
+}
@@ -1,120 +1,136 @@
-#ifndef GRAMANAL_H
-#define GRAMANAL_H
-#include <QSet>
-#include <QDebug>
-#include <QQueue>
-#include <QStack>
-#include "Util.h"
-
-struct Token{
-    QString content;
-    QString type;
-    Token(): content(""),type(""){}
-    Token(const QString& _type = "", const QString &_content="")
-        :content(_content), type(_type){}
-};
-
-// 语法树节点 结构体
-struct TokenNode{
-    QString content;  // 内容
-    QString type;       // 类型
-    vector<TokenNode*> child;
-//    TokenNode* sibling;         // 旁系节点
-    TokenNode(const QString& _type = "", const QString &_content="")
-        :content(_content), type(_type), child({}){}
-//    TokenNode& operator = (const TokenNode& tn) {
-//        content = tn.content;
-//        type = tn.type;
-//        child = tn.child;
-//        sibling = tn.sibling;
-//        return *this;
-//    }
-};
-// 结构体 记录 非终结符对应的 右部产生式 first
-struct Grammar {
-    QSet<QStringList> right; // 右部符号序列，有若干个产生式 producer
-    QSet<QString> first;
-    QSet<QString> follow;
-    Grammar(const QSet<QStringList>& r = {})
-        :right(r), first({}), follow({})  {}
-};
-
-
-class GramAnal {
-protected:
-    QString firstNonterm;   // 文法开始符号
-    QSet<QString> Terms;    // 终结符集合
-    QMap<QString, Grammar> grammars;// 语法规则 key 为 非终结符 ， value
-    QMap<QString,QMap<QString,QStringList>> AnalyTable; // LL1 分析表
-    vector<QString> order;  // 在最后输出 保证与 输入相同的顺序
-    vector<Token> tokens;  // 读取的记号数组 定义
-    TokenNode* root;  // 语法树根节点
-
-    void clearArg();        // 清除上面的所有变量
-    bool isTerm(const QString& symbol){return symbol != epsilon && Terms.contains(symbol);}
-    bool isNonTerm(const QString& symbol){return grammars.keys().contains(symbol);}
-
-
-    void updateGrammars(const QSet<QString>& removeVn); // 更新语法
-
-    bool hasAllTermProd(const Grammar& grammar); //
-    bool isThisVnRecursiveProd(const QString& Vn, const QStringList& prod); // 判断产生式是否为左递归
-    void rmHarmfulProd();   // 删除有害产生式
-    void rmNoArriveGram();  // 删除不可到达的文法
-    void rmNoStopGram();    // 删除不能停止的文法
-
-    void rmLeftRecursive();//    消除间接左递归
-    bool rmLeftDirectRecersive(const QString& Vn);//    消除直接左递归
-
-    void rmLeftCommonFactor();  // 消除间接左公因子
-    void rmLeftDirectCommonFactor();  // 消除直接左公因子
-
-    void genFirst(); // 生成first集合
-    void genFollow(); // 生成 follow 集合
-
-    QSet<QString> getProdFirst(const QStringList& prod); // 产生式的 first 集合WW
-    void genLLtable(); // 生成 LL1 分析表
-    bool LL1(); // 执行 LL1 分析
-
-public:
-    GramAnal();
-    ~GramAnal();
-    bool parseStrToGrammar (const QString& grammars);  // 分解字符串
-    bool Run(WindowState state, const QString strToken = "");
-
-    bool setTokens(const QString strToken);
-    QString toGramString(const QString& Vn) const;
-    QMap<QString, Grammar> getGrammars() const {return grammars;}
-    QMap<QString,QMap<QString,QStringList>> getAnalyTable() const {return AnalyTable;}
-    QSet<QString> getTerms() const {return Terms;}
-    QStringList getNonTerms() const {return grammars.keys();}
-    TokenNode* getRoot() const {return root;}
-
-    // test
-    void debugGram(const QString& hint = "test: "){
-        qDebug() << hint << "==============\n grammars: \n";
-        for(const auto& left:  grammars.keys()){
-            qDebug() << toGramString(left);
-        }
-    }
-    void debugTerm(const QString& hint = "test: "){
-        qDebug() << "\t\t" << hint << "==============\nTerms: " << Terms;
-    }
-    void debugNonTerm(const QString& hint = "test: "){
-        qDebug() << "\t\t" << hint << "===============\nNonTerms: " << grammars.keys();
-    }
-    void debugFirst(const QString& hint = "test: "){
-        qDebug() << "\t\t" << hint << "===============\nFirst: ";
-        for(const auto& Vn: grammars.keys()){
-            qDebug() << Vn << grammars[Vn].first;
-        }
-    }
-    void debugFollow(const QString& hint = "test: "){
-        qDebug() << "\t\t" << hint << "===============\nFollow: ";
-        for(const auto& Vn: grammars.keys()){
-            qDebug() << Vn << grammars[Vn].follow;
-        }
-    }
-};
-
-#endif // GRAMANAL_H
+#ifndef GRAMANAL_H
+#define GRAMANAL_H
+#include <QSet>
+#include <QDebug>
+#include <QQueue>
+#include <QStack>
+#include <QFile>
+#include "Util.h"
+#include "LexRuntime.h"
+
+struct Token{
+    QString content;
+    QString type;
+    unsigned long line;     // 在源文件中的行号，从 1 开始，0 表示不知道
+    unsigned long column;   // 列号（按字节），从 1 开始
+    Token(): content(""),type(""),line(0),column(0){}
+    Token(const QString& _type = "", const QString &_content="", unsigned long _line = 0, unsigned long _column = 0)
+        :content(_content), type(_type), line(_line), column(_column){}
+};
+
+// 语法树节点 结构体
+struct TokenNode{
+    QString content;  // 内容
+    QString type;       // 类型
+    unsigned long line, column; // 终结符在源文件中的位置，与 Token 相同，非终结符为 0
+    vector<TokenNode*> child;
+//    TokenNode* sibling;         // 旁系节点
+    TokenNode(const QString& _type = "", const QString &_content="")
+        :content(_content), type(_type), line(0), column(0), child({}){}
+//    TokenNode& operator = (const TokenNode& tn) {
+//        content = tn.content;
+//        type = tn.type;
+//        child = tn.child;
+//        sibling = tn.sibling;
+//        return *this;
+//    }
+};
+// 结构体 记录 非终结符对应的 右部产生式 first
+struct Grammar {
+    QSet<QStringList> right; // 右部符号序列，有若干个产生式 producer
+    QSet<QString> first;
+    QSet<QString> follow;
+    Grammar(const QSet<QStringList>& r = {})
+        :right(r), first({}), follow({})  {}
+};
+
+
+class GramAnal {
+protected:
+    QString firstNonterm;   // 文法开始符号
+    QSet<QString> Terms;    // 终结符集合
+    QMap<QString, Grammar> grammars;// 语法规则 key 为 非终结符 ， value
+    QMap<QString,QMap<QString,QStringList>> AnalyTable; // LL1 分析表
+    vector<QString> order;  // 在最后输出 保证与 输入相同的顺序
+    vector<Token> tokens;  // 读取的记号数组 定义
+    size_t tokenIndex;      // LL1 读到的记号在 tokens 中的下标
+    QFile tokenFile;        // 映射到内存的二进制单词流文件
+    LexStreamReader tokenStream;    // 直接在映射的内存上读单词流，打开时 LL1 从这里读记号
+    vector<QString> streamKinds;    // 单词流的种别名，同一种别的记号共用一个 QString
+    LexLineCounter streamLines;     // 按记号的顺序在单词流的源文本中计算行号和列号
+    bool readToken(Token& tok);     // LL1 读入下一个记号，没有了返回 false
+    TokenNode* root;  // 语法树根节点
+
+    void clearArg();        // 清除上面的所有变量
+    bool isTerm(const QString& symbol){return symbol != epsilon && Terms.contains(symbol);}
+    bool isNonTerm(const QString& symbol){return grammars.keys().contains(symbol);}
+
+
+    void updateGrammars(const QSet<QString>& removeVn); // 更新语法
+
+    bool hasAllTermProd(const Grammar& grammar); //
+    bool isThisVnRecursiveProd(const QString& Vn, const QStringList& prod); // 判断产生式是否为左递归
+    void rmHarmfulProd();   // 删除有害产生式
+    void rmNoArriveGram();  // 删除不可到达的文法
+    void rmNoStopGram();    // 删除不能停止的文法
+
+    void rmLeftRecursive();//    消除间接左递归
+    bool rmLeftDirectRecersive(const QString& Vn);//    消除直接左递归
+
+    void rmLeftCommonFactor();  // 消除间接左公因子
+    void rmLeftDirectCommonFactor();  // 消除直接左公因子
+
+    void genFirst(); // 生成first集合
+    void genFollow(); // 生成 follow 集合
+
+    QSet<QString> getProdFirst(const QStringList& prod); // 产生式的 first 集合WW
+    void genLLtable(); // 生成 LL1 分析表
+    bool LL1(); // 执行 LL1 分析
+    bool buildTable(WindowState state); // 执行 LL1 分析之前的各步，state 已经完成时返回 true
+
+public:
+    GramAnal();
+    ~GramAnal();
+    bool parseStrToGrammar (const QString& grammars);  // 分解字符串
+    bool Run(WindowState state, const QString strToken = "");
+    bool Run(WindowState state, const vector<Token>& tokenList);
+    bool RunTokenStream(WindowState state, const QString& path);   // 记号来自二进制单词流文件
+
+    bool setTokens(const QString strToken);
+    void setTokens(const vector<Token>& tokenList);
+    bool setTokenStream(const QString& path);
+    QString toGramString(const QString& Vn) const;
+    QMap<QString, Grammar> getGrammars() const {return grammars;}
+    QMap<QString,QMap<QString,QStringList>> getAnalyTable() const {return AnalyTable;}
+    QSet<QString> getTerms() const {return Terms;}
+    QStringList getNonTerms() const {return grammars.keys();}
+    TokenNode* getRoot() const {return root;}
+
+    // test
+    void debugGram(const QString& hint = "test: "){
+        qDebug() << hint << "==============\n grammars: \n";
+        for(const auto& left:  grammars.keys()){
+            qDebug() << toGramString(left);
+        }
+    }
+    void debugTerm(const QString& hint = "test: "){
+        qDebug() << "\t\t" << hint << "==============\nTerms: " << Terms;
+    }
+    void debugNonTerm(const QString& hint = "test: "){
+        qDebug() << "\t\t" << hint << "===============\nNonTerms: " << grammars.keys();
+    }
+    void debugFirst(const QString& hint = "test: "){
+        qDebug() << "\t\t" << hint << "===============\nFirst: ";
+        for(const auto& Vn: grammars.keys()){
+            qDebug() << Vn << grammars[Vn].first;
+        }
+    }
+    void debugFollow(const QString& hint = "test: "){
+        qDebug() << "\t\t" << hint << "===============\nFollow: ";
+        for(const auto& Vn: grammars.keys()){
+            qDebug() << Vn << grammars[Vn].follow;
+        }
+    }
+};
+
+#endif // GRAMANAL_H
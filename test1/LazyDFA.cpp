@@ -0,0 +1,131 @@
+#include "LazyDFA.h"
+const uint32_t LazyDFA::DEAD;
+const uint32_t LazyDFA::UNKNOWN;
+const size_t LazyDFA::DEFAULT_BUDGET;
+/**
+ * @brief 构造按需 DFA
+ * @param _lex 已经解析过规则（至少到 lazyDfa 阶段）的词法分析器
+ * @param _budget 缓存的字节数上限
+ * @note 预先计算每个转移字符匹配哪些等价类，并把 NFA 初态的空边闭包作为 0 号状态
+ */
+LazyDFA::LazyDFA(const WordAnal& _lex, size_t _budget)
+    : lex(_lex), budget(_budget), usedBytes(0), columns(_lex.getClassCount() + 1),
+      anySym(SymbolTable::instance().find("AnyChar")), hits(0), misses(0), flushes(0) {
+    const vector<size_t>& rankSym = lex.getRankSym();
+    rankMatch.assign(rankSym.size(), vector<char>(columns - 1, 0));
+    for (size_t r = 0; r < rankSym.size(); r++)
+        if (rankSym[r] != anySym)   // AnyChar 单独处理，不算显式的出边
+            for (auto c : lex.getSymClasses()[rankSym[r]])
+                rankMatch[r][c] = 1;
+    addState(lex.getEpClosure(0));
+}
+
+/**
+ * @brief 把一个 NFA 子集登记为新的缓存状态
+ * @return 新状态的 id
+ * @note 状态的规则序号取子集中 NFA 终态的最小规则序号，与 CreateDFA 一致
+ */
+uint32_t LazyDFA::addState(const StateSet& s) {
+    const Automaton& nfa = lex.getNFAgraph();
+    int32_t rule = -1;
+    for (auto p : s) {
+        int32_t r = nfa.getAccept(p);
+        if (r >= 0 && (rule < 0 || r < rule))
+            rule = r;
+    }
+    uint32_t id = uint32_t(subsets.size());
+    subsets.push_back(s);
+    index[s] = id;
+    trans.resize(trans.size() + columns, UNKNOWN);
+    accepts.push_back(rule);
+    // 转移表的一行、子集本身和索引中的副本，再加上哈希表节点的大致开销
+    usedBytes += columns * sizeof(uint32_t) + 2 * s.bytes() + sizeof(int32_t) + 32;
+    return id;
+}
+
+/**
+ * @brief 查找子集对应的缓存状态，不存在则新建
+ * @note 新建之前如果超过内存上限，先清空缓存，此时之前返回的状态 id 全部失效
+ */
+uint32_t LazyDFA::cached(const StateSet& s) {
+    auto it = index.find(s);
+    if (it != index.end())
+        return it->second;
+    size_t need = columns * sizeof(uint32_t) + 2 * s.bytes() + sizeof(int32_t) + 32;
+    if (usedBytes + need > budget && subsets.size() > 1) {
+        flush();
+        it = index.find(s);     // 可能正好是初态
+        if (it != index.end())
+            return it->second;
+    }
+    return addState(s);
+}
+
+// 清空缓存，只保留初态
+void LazyDFA::flush() {
+    StateSet startSet = subsets[0];
+    vector<StateSet>().swap(subsets);
+    unordered_map<StateSet, uint32_t, StateSetHash>().swap(index);
+    vector<uint32_t>().swap(trans);
+    vector<int32_t>().swap(accepts);
+    usedBytes = 0;
+    flushes++;
+    addState(startSet);
+}
+
+/**
+ * @brief 计算缓存状态 s 在某个等价类（或 AnyChar）下的下一个 NFA 子集
+ * @param s 缓存状态
+ * @param column 等价类的 id，columns - 1 表示 AnyChar
+ * @return 下一个子集，不能转移时为空集
+ * @note 显式的出边按转移字符的顺序只取第一个能匹配的转移字符，
+ * 与 DFA 中按 transChar 顺序排列的出边、生成程序中的 if / else if 顺序一致。
+ */
+StateSet LazyDFA::nextSet(uint32_t s, size_t column) const {
+    const Automaton& nfa = lex.getNFAgraph();
+    const vector<size_t>& symRank = lex.getSymRank();
+    StateSet res;
+    size_t sym = anySym;
+    if (column != columns - 1) {    // 找出能匹配的序号最小的转移字符
+        size_t best = NO_EDGE;
+        for (auto p : subsets[s])
+            for (auto & edge : nfa.getEdges(p)) {
+                size_t r = edge.sym < symRank.size() ? symRank[edge.sym] : NO_EDGE;
+                if (r != NO_EDGE && r < best && rankMatch[r][column])
+                    best = r;
+            }
+        if (best == NO_EDGE)
+            return res;
+        sym = lex.getRankSym()[best];
+    }
+    if (sym == NO_EDGE)
+        return res;
+    for (auto p : subsets[s])
+        for (auto & edge : nfa.getEdges(p))
+            if (edge.sym == sym)
+                res.unite(lex.getEpClosure(edge.tail));
+    return res;
+}
+
+/**
+ * @brief 走一步转移，先查缓存，没有再由 NFA 计算并登记
+ * @return 下一个状态，不能转移返回 DEAD
+ */
+uint32_t LazyDFA::move(uint32_t s, size_t column) {
+    uint32_t t = trans[s * columns + column];
+    if (t != UNKNOWN) {
+        hits++;
+        return t;
+    }
+    misses++;
+    StateSet next = nextSet(s, column);
+    if (next.empty()) {
+        trans[s * columns + column] = DEAD;
+        return DEAD;
+    }
+    size_t before = flushes;
+    uint32_t id = cached(next);
+    if (flushes == before)  // 清空缓存后 s 已经失效，不再记录这条转移
+        trans[s * columns + column] = id;
+    return id;
+}
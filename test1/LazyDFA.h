@@ -0,0 +1,51 @@
+#ifndef LAZYDFA_H
+#define LAZYDFA_H
+/*
+ * 文件名:LazyDFA.h
+ * 摘要：按需构造的 DFA
+ *
+ * 不做完整的子集构造，只在第一次走某个转移时由 NFA 子集计算下一个状态，
+ * 状态和转移缓存在有内存上限的表中；超过上限时清空缓存，从当前状态重新开始。
+*/
+#include "WordAnal.h"
+#include "LexRuntime.h"
+
+class LazyDFA {
+public:
+    static const uint32_t DEAD = UINT32_MAX - 1;    // 没有转移
+    static const uint32_t UNKNOWN = UINT32_MAX;     // 转移还没有计算过
+    static const size_t DEFAULT_BUDGET = 1 << 20;   // 规则中没有 LazyDFACache 时缓存的字节数上限
+private:
+    const WordAnal& lex;        // 提供 NFA 图、空边闭包和字符等价类，使用期间不能重新解析
+    size_t budget;              // 缓存的字节数上限
+    size_t usedBytes;           // 缓存已经占用的字节数
+    size_t columns;             // 每个状态一行：各个等价类的显式转移，最后一列为 AnyChar 转移
+    size_t anySym;              // AnyChar 的符号 id，没有为 NO_EDGE
+    vector<vector<char>> rankMatch; // rankMatch[序号][等价类]：该转移字符是否匹配这个等价类
+
+    vector<StateSet> subsets;   // 缓存的状态 -> NFA 子集
+    unordered_map<StateSet, uint32_t, StateSetHash> index;  // NFA 子集 -> 缓存的状态
+    vector<uint32_t> trans;     // trans[s * columns + c]
+    vector<int32_t> accepts;    // 状态的规则序号
+    size_t hits, misses, flushes;
+
+    uint32_t addState(const StateSet& s);
+    uint32_t cached(const StateSet& s);     // 查找或新建状态，必要时先清空缓存
+    void flush();
+    StateSet nextSet(uint32_t s, size_t column) const;  // 计算子集在一个等价类（或 AnyChar）下的下一子集
+    uint32_t move(uint32_t s, size_t column);
+public:
+    LazyDFA(const WordAnal& _lex, size_t _budget = DEFAULT_BUDGET);
+
+    uint32_t start() const { return 0; }   // 清空缓存时总是先放回初态，初态固定为 0 号
+    uint32_t step(uint32_t s, unsigned char ch) { return move(s, lex.getCharClass()[ch]); }
+    uint32_t stepAny(uint32_t s) { return move(s, columns - 1); }
+    int32_t accept(uint32_t s) const { return accepts[s]; }
+
+    size_t getHits() const { return hits; }         // 转移命中缓存的次数
+    size_t getMisses() const { return misses; }     // 转移需要计算的次数
+    size_t getFlushes() const { return flushes; }   // 超过上限清空缓存的次数
+    size_t getStateCount() const { return subsets.size(); }
+    size_t getUsedBytes() const { return usedBytes; }
+};
+#endif // LAZYDFA_H
@@ -0,0 +1,485 @@
+#ifndef LEXRUNTIME_H
+#define LEXRUNTIME_H
+/*
+ * 文件名:LexRuntime.h
+ * 摘要：进程内词法分析的公共部分：单词的表示和扫描驱动
+ *
+ * 单词只记录种别和在输入中的位置，不复制文本。
+ * 扫描驱动与具体的自动机无关，自动机只需要提供 start / step / stepAny / accept 四个操作。
+ * scanTokensParallel 把输入分块，在多个线程中推测地扫描，再拼接成与顺序扫描完全相同的结果；
+ * runWorkStealing 是批量扫描多个文件时使用的线程池。
+ * LexStreamWriter / LexStreamReader 写出和读入二进制单词流，词法分析和语法分析之间不必再经过文本。
+ * 单词的行号和列号不在扫描时计算，需要时由 LexLineCounter 按单词的顺序成块统计换行符得到。
+*/
+#include <vector>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+const int32_t LEX_ERROR = -1;   // 出错的单词
+
+// 一个单词：种别为规则序号（出错为 LEX_ERROR），文本为输入中 [offset, offset + length) 的一段
+struct LexToken {
+    int32_t kind;
+    size_t offset;
+    size_t length;
+};
+
+// 单词在输入中的位置：行号和列号都从 1 开始，列按字节计
+struct LexPosition {
+    unsigned long line;
+    unsigned long column;
+};
+
+/**
+ * @brief 统计 [s, s + n) 中的换行符
+ * @param [out] after 有换行符时为最后一个换行符之后的下标，没有时不变
+ * @return 换行符的个数
+ * @note SSE2 时每次比较 16 个字节，用 popcount 统计掩码中 1 的个数，最高位的 1 即最后一个换行符；
+ * 与生成的程序中的 countLines 相同（WordAnal::genLineCounter）。
+ */
+inline size_t lexCountLines(const char* s, size_t n, size_t& after) {
+    size_t lines = 0, i = 0;
+#if defined(__GNUC__) && defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; i + 16 <= n; i += 16) {
+        unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)), nl)));
+        if (mask) {
+            lines += size_t(__builtin_popcount(mask));
+            after = i + 32 - size_t(__builtin_clz(mask));
+        }
+    }
+#endif
+    for (; i < n; i++)
+        if (s[i] == '\n') {
+            lines++;
+            after = i + 1;
+        }
+    return lines;
+}
+
+// 按单词的顺序计算行号和列号：每次只统计上一个单词的起点到这个单词的起点之间（跳过的空白和上一个单词）的换行符
+class LexLineCounter {
+public:
+    explicit LexLineCounter(const char* input = nullptr) { reset(input); }
+    void reset(const char* input) {
+        data = input;
+        counted = lineStart = 0;
+        line = 1;
+    }
+    // offset 不能小于上一次的 offset
+    LexPosition at(size_t offset) {
+        size_t after = 0;
+        size_t lines = lexCountLines(data + counted, offset - counted, after);
+        if (lines) {
+            line += lines;
+            lineStart = counted + after;
+        }
+        counted = offset;
+        LexPosition pos = {line, offset - lineStart + 1};
+        return pos;
+    }
+private:
+    const char* data;
+    size_t counted, lineStart;
+    unsigned long line;
+};
+
+// 批量扫描多个文件的统计
+struct LexBatchStats {
+    size_t files;       // 文件数
+    size_t failed;      // 打不开或者有出错单词的文件数
+    uint64_t bytes;     // 读入的总字节数
+};
+
+/**
+ * @brief 按照生成的词法分析程序的规则扫描输入，得到单词序列
+ * @param m 自动机，需要提供：
+ *      - uint32_t start()：初态
+ *      - uint32_t step(uint32_t s, unsigned char ch)：按转移字符的顺序尝试显式的出边，没有返回 Matcher::DEAD
+ *      - uint32_t stepAny(uint32_t s)：AnyChar 出边，没有返回 Matcher::DEAD
+ *      - int32_t accept(uint32_t s)：终态的规则序号，非终态为 -1
+ * @param data 输入
+ * @param size 输入的字节数
+ * @param [out] out 追加得到的单词
+ * @param from 从这里开始扫描，当作一个单词的起点
+ * @param stop 下一个单词的起点（跳过空白字符之后）不小于 stop 时停止，默认扫描到输入结束
+ * @return 没有出错返回 true
+ * @note 与 genProgram 生成的程序一致：
+ * 初态跳过空白字符；先尝试显式的出边；不能转移时如果当前是终态，输出单词并用同一个字符从初态重新开始；
+ * 否则尝试 AnyChar 出边；都不行时，如果当前单词经过了终态，退回到最后经过的终态输出那个单词（最长匹配），
+ * 从那里重新开始；否则输出一个出错单词并停止。
+ * 输入结束时同样处理：终态输出最后一个单词，否则回退或者把没有读完的部分作为出错单词。
+ */
+template<class Matcher>
+bool scanTokens(Matcher& m, const char* data, size_t size, vector<LexToken>& out,
+                size_t from = 0, size_t stop = SIZE_MAX) {
+    uint32_t start = m.start(), state = start;
+    size_t begin = from;    // 当前单词的起点
+    size_t i = from;
+    int32_t lastRule = LEX_ERROR;   // 当前单词最后经过的终态的规则序号
+    size_t lastEnd = 0;             // 以及那时的位置
+    while (true) {
+        uint32_t next = Matcher::DEAD;
+        if (i < size) {
+            unsigned char ch = static_cast<unsigned char>(data[i]);
+            if (state == start && (ch == ' ' || ch == '\t' || ch == '\n')) {
+                begin = ++i;
+                if (begin >= stop)
+                    return true;
+                continue;
+            }
+            next = m.step(state, ch);
+            if (next == Matcher::DEAD && m.accept(state) < 0)
+                next = m.stepAny(state);
+        } else if (state == start)
+            return true;
+        if (next != Matcher::DEAD) {
+            state = next;
+            i++;
+            if (m.accept(state) >= 0) {
+                lastRule = m.accept(state);
+                lastEnd = i;
+            }
+            continue;
+        }
+        LexToken tok = {m.accept(state), begin, i - begin};
+        if (tok.kind < 0 && lastRule >= 0) {    // 回退到最后经过的终态
+            tok.kind = lastRule;
+            tok.length = lastEnd - begin;
+            i = lastEnd;
+        }
+        out.push_back(tok);
+        if (tok.kind == LEX_ERROR)
+            return false;
+        if (i >= stop)
+            return true;
+        state = start = m.start();
+        begin = i;
+        lastRule = LEX_ERROR;
+    }
+}
+
+/**
+ * @brief 把输入分成与线程数相同的块，每块在一个线程中推测地扫描，再拼接成与顺序扫描完全相同的单词序列
+ * @param scanRange 扫描一段输入：bool scanRange(size_t from, size_t stop, vector<LexToken>& part)，
+ * 与 scanTokens(m, data, size, part, from, stop) 相同，会在多个线程中同时调用；
+ * 注释也要作为单词输出，相邻的单词之间只能是空白字符
+ * @param size 输入的字节数
+ * @param [out] out 追加得到的单词
+ * @param threads 线程数，为 0 时取硬件的线程数；不大于 1 或输入太小时直接顺序扫描
+ * @return 没有出错返回 true
+ * @note 扫描器在每个单词的起点都处于初态，之后的单词只由这个起点决定，与怎样到达这里无关。
+ * 因此第 k 块 [b[k], b[k + 1]) 推测 b[k] 是一个单词的起点，从初态开始扫描，得到起点在块内的单词。
+ * 拼接时按顺序处理各块，pos 为真实的扫描已经确定的位置（初态）：
+ *      - pos 正好是块的起点时推测正确，整块的结果直接采用
+ *      - 否则从 pos 开始真实地扫描一小段（每次加倍），一旦得到的某个单词的起点也是推测结果中某个单词的起点，
+ *        两边从这里开始完全相同，直接采用推测结果的其余部分；块的起点落在注释、字符串的中间时，
+ *        推测的结果一般在注释、字符串结束后几个单词内就能对上
+ *      - 单词跨过了整块时跳过这一块的推测结果
+ * 出错的单词只有在真实的扫描经过它时才会采用，之后停止，与顺序扫描相同。
+ */
+template<class ScanRange>
+bool scanTokensParallel(ScanRange scanRange, size_t size, vector<LexToken>& out, unsigned threads = 0) {
+    const size_t minChunk = 1 << 20;    // 每块至少 1 MB，太小时线程的开销超过收益
+    const size_t firstStep = 256;       // 推测没有对上时，第一次真实扫描的长度
+    if (threads == 0)
+        threads = max(thread::hardware_concurrency(), 1u);
+    size_t n = min<size_t>(threads, size / minChunk);
+    if (n <= 1)
+        return scanRange(0, SIZE_MAX, out);
+
+    vector<size_t> b(n + 1);
+    for (size_t k = 0; k <= n; k++)
+        b[k] = size / n * k;
+    b[n] = SIZE_MAX;    // 最后一块扫描到输入结束
+    vector<vector<LexToken>> part(n);
+    vector<char> ok(n);
+    vector<thread> workers;
+    for (size_t k = 1; k < n; k++)
+        workers.emplace_back([&, k] { ok[k] = scanRange(b[k], b[k + 1], part[k]); });
+    ok[0] = scanRange(0, b[1], part[0]);
+    for (auto & w : workers)
+        w.join();
+
+    auto endOf = [](const LexToken& t) { return t.offset + t.length; };
+    vector<LexToken> real;
+    size_t pos = 0;
+    for (size_t k = 0; k < n; k++) {
+        if (pos >= b[k + 1])    // 单词跨过了整块
+            continue;
+        const vector<LexToken>& p = part[k];
+        if (pos == b[k]) {  // 推测正确
+            out.insert(out.end(), p.begin(), p.end());
+            if (!ok[k])
+                return false;
+            pos = p.empty() ? b[k + 1] : max(endOf(p.back()), b[k + 1]);
+            continue;
+        }
+        for (size_t step = firstStep; pos < b[k + 1]; step *= 2) {
+            size_t stop = min(pos + step, b[k + 1]);
+            real.clear();
+            bool good = scanRange(pos, stop, real);
+            // 两个序列都按起点排列，找第一个起点相同的单词
+            size_t i = 0, j = lower_bound(p.begin(), p.end(), pos,
+                                          [](const LexToken& t, size_t v) { return t.offset < v; }) - p.begin();
+            for (; i < real.size(); i++) {
+                while (j < p.size() && p[j].offset < real[i].offset)
+                    j++;
+                if (j < p.size() && p[j].offset == real[i].offset)
+                    break;
+            }
+            out.insert(out.end(), real.begin(), real.begin() + i);
+            if (i < real.size()) {  // 对上了，采用推测结果的其余部分
+                out.insert(out.end(), p.begin() + j, p.end());
+                if (!ok[k])
+                    return false;
+                pos = max(endOf(p.back()), b[k + 1]);
+                break;
+            }
+            if (!good)
+                return false;
+            if (stop >= size)   // 已经扫描到输入结束
+                return true;
+            pos = real.empty() ? stop : max(endOf(real.back()), stop);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 在 threads 个线程中执行 task(0) ~ task(count - 1)，任务之间没有依赖，全部完成后返回
+ * @note 每个线程有自己的任务队列（按序号轮流分配），从自己的队首取任务，空了就从其它线程的队尾偷一个，
+ * 任务的耗时相差很大时（如大小不同的文件）也不会有线程早早空闲。任务执行时不会再加入新任务，
+ * 所以所有队列都空了就可以结束。与 WordAnal::genBatchMain 生成的程序中的线程池相同。
+ */
+template<class Task>
+void runWorkStealing(size_t count, unsigned threads, Task task) {
+    struct WorkQueue {
+        mutex m;
+        deque<size_t> jobs;
+    };
+    threads = unsigned(max<size_t>(min<size_t>(threads, count), 1));
+    vector<WorkQueue> queues(threads);
+    for (size_t i = 0; i < count; i++)
+        queues[i % threads].jobs.push_back(i);
+    auto worker = [&](unsigned self) {
+        for (;;) {
+            size_t job = 0;
+            bool found = false;
+            for (unsigned k = 0; k < threads && !found; k++) {
+                WorkQueue& q = queues[(self + k) % threads];
+                lock_guard<mutex> lock(q.m);
+                if (q.jobs.empty())
+                    continue;
+                if (k == 0) {
+                    job = q.jobs.front();
+                    q.jobs.pop_front();
+                } else {
+                    job = q.jobs.back();
+                    q.jobs.pop_back();
+                }
+                found = true;
+            }
+            if (!found)
+                return;
+            task(job);
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto & t : pool)
+        t.join();
+}
+/*
+ * 二进制单词流（.lexb），所有整数都是小端序：
+ *      文件头 28 字节："LEXB"、版本（1 字节，为 1）、标志（1 字节，LEXB_VARINT）、保留（2 字节），
+ *                     种别数 u32、单词数 u64、源文本的字节数 u64
+ *      种别字典：每个种别为 u16 长度加名字（UTF-8），单词的种别 id 就是它在字典中的序号
+ *      源文本：单词的起点都相对于它，读入时直接取其中的一段作为单词的文本
+ *      单词记录：定长时每个单词 12 字节：种别 id u32、起点 u32、长度 u32，源文本不能超过 4 GB；
+ *               LEXB_VARINT 时每个单词三个 varint（每字节 7 位，最高位为 1 表示后面还有）：
+ *               种别 id、起点减去上一个单词的终点、长度，通常每个单词只要 3 个字节
+ * 内容与文本格式相同：注释不写出，出错的单词种别为 "ErrorState"。
+ * 单词流中有源文本，所以不记录行号和列号，读入时用 LexLineCounter 计算。
+ * 生成的程序（-b / -B 选项，WordAnal::genBatchMain）和 WordAnal::tokenStream 写出，
+ * GramAnal::setTokenStream 把文件映射到内存后直接读记录。
+ */
+const uint8_t LEXB_VERSION = 1;
+const uint8_t LEXB_VARINT = 1;      // 单词记录为变长的差分编码
+const size_t LEXB_HEADER = 28;      // 文件头的字节数
+const uint64_t LEXB_FIXED_MAX = 0xffffffffu;    // 定长记录的起点和长度为 u32，源文本不能超过这个字节数
+
+// 写出二进制单词流：begin 写出文件头、种别字典和源文本，put 逐个追加单词，finish 补上单词数；
+// 定长记录时源文本超过 LEXB_FIXED_MAX 会截断起点和长度，begin 返回 false，不能继续写
+class LexStreamWriter {
+public:
+    bool begin(const vector<string>& kinds, const char* text, size_t size, bool varint) {
+        out.clear();
+        if (!varint && uint64_t(size) > LEXB_FIXED_MAX)
+            return false;
+        out.assign("LEXB");
+        out += char(LEXB_VERSION);
+        out += char(varint ? LEXB_VARINT : 0);
+        putFixed(0, 2);
+        putFixed(kinds.size(), 4);
+        putFixed(0, 8);     // 单词数在 finish 中补上
+        putFixed(size, 8);
+        for (auto & kind : kinds) {
+            putFixed(kind.size(), 2);
+            out += kind;
+        }
+        out.append(text, size);
+        compact = varint;
+        count = 0;
+        lastEnd = 0;
+        return true;
+    }
+    void put(uint32_t kind, uint64_t offset, uint64_t length) {
+        if (compact) {
+            putVarint(kind);
+            putVarint(offset - lastEnd);
+            putVarint(length);
+        } else {
+            putFixed(kind, 4);
+            putFixed(offset, 4);
+            putFixed(length, 4);
+        }
+        lastEnd = offset + length;
+        count++;
+    }
+    const string& finish() {
+        for (size_t i = 0; i < 8; i++)
+            out[12 + i] = char(count >> (8 * i) & 0xff);
+        return out;
+    }
+private:
+    string out;
+    bool compact;
+    uint64_t count, lastEnd;
+    void putFixed(uint64_t v, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++)
+            out += char(v >> (8 * i) & 0xff);
+    }
+    void putVarint(uint64_t v) {
+        for (; v >= 0x80; v >>= 7)
+            out += char((v & 0x7f) | 0x80);
+        out += char(v);
+    }
+};
+
+/**
+ * @brief 读入内存中（一般是映射到内存的文件）的二进制单词流，不复制任何数据
+ * @note open 检查文件头并记下种别字典中各个名字的位置（失败时与 close 之后一样是空的），next 按顺序解码下一条单词记录，
+ * 单词的文本为 text() + offset 处的 length 个字节。内存要在读完之前一直有效。
+ * 记录不完整、种别 id 或位置越界（包括差分编码的起点加上上一个单词的终点之后越界）时 next 返回 false，
+ * 与读完一样；调用者可以用 index() 与 count() 区分。
+ */
+class LexStreamReader {
+public:
+    LexStreamReader() { close(); }
+    void close() {
+        kinds.clear();
+        begin = cur = end = nullptr;
+        textData = nullptr;
+        textBytes = tokenCount = 0;
+        read = lastEnd = 0;
+        compact = false;
+    }
+    bool open(const unsigned char* data, size_t size) {
+        close();
+        if (size < LEXB_HEADER || memcmp(data, "LEXB", 4) != 0 || data[4] != LEXB_VERSION)
+            return false;
+        end = data + size;
+        compact = (data[5] & LEXB_VARINT) != 0;
+        uint64_t kindCount = fixed(data + 8, 4);
+        tokenCount = fixed(data + 12, 8);
+        textBytes = fixed(data + 20, 8);
+        const unsigned char* p = data + LEXB_HEADER;
+        for (uint64_t k = 0; k < kindCount; k++) {
+            if (end - p < 2 || uint64_t(end - p - 2) < fixed(p, 2)) {
+                close();
+                return false;
+            }
+            size_t len = size_t(fixed(p, 2));
+            kinds.push_back(make_pair(reinterpret_cast<const char*>(p + 2), len));
+            p += 2 + len;
+        }
+        if (uint64_t(end - p) < textBytes) {
+            close();
+            return false;
+        }
+        textData = reinterpret_cast<const char*>(p);
+        begin = cur = p + textBytes;
+        return true;
+    }
+    size_t kindCount() const { return kinds.size(); }
+    const char* kindName(size_t kind, size_t& length) const {
+        length = kinds[kind].second;
+        return kinds[kind].first;
+    }
+    const char* text() const { return textData; }
+    uint64_t textSize() const { return textBytes; }
+    uint64_t count() const { return tokenCount; }
+    uint64_t index() const { return read; }     // 已经读出的单词数
+    void rewind() { cur = begin; read = lastEnd = 0; }
+    bool next(LexToken& tok) {
+        if (read >= tokenCount)
+            return false;
+        uint64_t kind, offset, length;
+        if (compact) {
+            if (!varint(kind) || !varint(offset) || !varint(length) || offset > textBytes - lastEnd)
+                return false;
+            offset += lastEnd;
+        } else {
+            if (end - cur < 12)
+                return false;
+            kind = fixed(cur, 4);
+            offset = fixed(cur + 4, 4);
+            length = fixed(cur + 8, 4);
+            cur += 12;
+        }
+        if (kind >= kinds.size() || offset > textBytes || length > textBytes - offset)
+            return false;
+        tok.kind = int32_t(kind);
+        tok.offset = size_t(offset);
+        tok.length = size_t(length);
+        lastEnd = offset + length;
+        read++;
+        return true;
+    }
+private:
+    vector<pair<const char*, size_t>> kinds;    // 种别名在字典中的位置和长度
+    const unsigned char *begin, *cur, *end;     // 单词记录的开始、下一条记录、数据的结束
+    const char* textData;
+    uint64_t textBytes, tokenCount, read, lastEnd;
+    bool compact;
+    static uint64_t fixed(const unsigned char* p, size_t bytes) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; i++)
+            v |= uint64_t(p[i]) << (8 * i);
+        return v;
+    }
+    bool varint(uint64_t& v) {
+        v = 0;
+        for (unsigned shift = 0; cur < end && shift < 64; shift += 7) {
+            unsigned char b = *cur++;
+            v |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+};
+#endif // LEXRUNTIME_H
@@ -0,0 +1,30 @@
+#include "SDFAMatcher.h"
+const uint32_t SDFAMatcher::DEAD;
+/**
+ * @brief 由确定的自动机构造转移表
+ * @param lex 已经解析过规则的词法分析器，提供字符等价类
+ * @param graph lex 中的 SDFA 或 DFA
+ * @note 每个等价类取出边中第一条覆盖它的边（buildTransitionRows），
+ * 与生成程序中 if / else if 的顺序一致；等价类不超过 256 个，用一个字节记录。
+ */
+SDFAMatcher::SDFAMatcher(const WordAnal& lex, const Automaton& graph)
+    : startState(uint32_t(graph.getStart())), columns(lex.getClassCount()) {
+    const vector<size_t>& charClass = lex.getCharClass();
+    for (int ch = 0; ch < 256; ch++)
+        cls[ch] = static_cast<unsigned char>(charClass[ch]);
+
+    vector<vector<int32_t>> dense;
+    vector<int32_t> any;
+    lex.buildTransitionRows(graph, dense, any);
+    trans.assign(graph.size() * columns, DEAD);
+    anyNext.assign(graph.size(), DEAD);
+    accepts.resize(graph.size());
+    for (size_t s = 0; s < graph.size(); s++) {
+        for (size_t c = 0; c < columns; c++)
+            if (dense[s][c] >= 0)
+                trans[s * columns + c] = uint32_t(dense[s][c]);
+        if (any[s] >= 0)
+            anyNext[s] = uint32_t(any[s]);
+        accepts[s] = graph.getAccept(s);
+    }
+}
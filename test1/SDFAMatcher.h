@@ -0,0 +1,36 @@
+#ifndef SDFAMATCHER_H
+#define SDFAMATCHER_H
+/*
+ * 文件名:SDFAMatcher.h
+ * 摘要：直接解释执行 SDFA（或 DFA）的转移表，不生成和编译程序
+ *
+ * 构造时把自动机按字符等价类展开成一张稠密的 [状态][等价类] 转移表，
+ * 扫描时每个字节只需查一次等价类和一次转移表，与生成的表格形式程序的转移完全相同。
+*/
+#include "WordAnal.h"
+#include "LexRuntime.h"
+
+class SDFAMatcher {
+public:
+    static const uint32_t DEAD = UINT32_MAX - 1;    // 没有转移
+private:
+    uint32_t startState;        // 自动机的初态
+    size_t columns;             // 每个状态一行，每个等价类一列
+    unsigned char cls[256];     // 字节 -> 等价类
+    vector<uint32_t> trans;     // trans[s * columns + c]，没有转移为 DEAD
+    vector<uint32_t> anyNext;   // AnyChar 出边，没有或为终态时为 DEAD
+    vector<int32_t> accepts;    // 状态的规则序号，非终态为 -1
+public:
+    // graph 为 lex 中的 SDFA 或 DFA；构造之后不再引用 lex，重新解析规则不影响已构造的对象
+    SDFAMatcher(const WordAnal& lex, const Automaton& graph);
+    explicit SDFAMatcher(const WordAnal& lex) : SDFAMatcher(lex, lex.getSDFAgraph()) {}
+
+    uint32_t start() const { return startState; }
+    uint32_t step(uint32_t s, unsigned char ch) const { return trans[s * columns + cls[ch]]; }
+    uint32_t stepAny(uint32_t s) const { return anyNext[s]; }
+    int32_t accept(uint32_t s) const { return accepts[s]; }
+
+    size_t getStateCount() const { return accepts.size(); }
+    size_t getTableBytes() const { return trans.size() * sizeof(uint32_t); }
+};
+#endif // SDFAMATCHER_H
@@ -0,0 +1,63 @@
+#include "ScannerLibrary.h"
+
+/**
+ * @brief 加载共享库，取得扫描函数
+ * @param fileName 共享库的路径
+ * @return 加载成功并找到 scan、scan_range 和 scan_rule_count 返回 true
+ * @note 规则变化后共享库的文件名（内容的散列）也会变化，加载新的库之前先卸载旧的，
+ * 避免旧的代码一直留在进程中；同一个文件已经加载时直接返回。
+ */
+bool ScannerLibrary::load(const QString& fileName) {
+    if (isLoaded() && library.fileName() == fileName)
+        return true;
+    unload();
+    library.setFileName(fileName);
+    if (!library.load())
+        return false;
+    scanFunc = reinterpret_cast<ScanFunc>(library.resolve("scan"));
+    scanRangeFunc = reinterpret_cast<ScanRangeFunc>(library.resolve("scan_range"));
+    ruleCountFunc = reinterpret_cast<RuleCountFunc>(library.resolve("scan_rule_count"));
+    if (!scanFunc || !scanRangeFunc || !ruleCountFunc) {
+        unload();
+        return false;
+    }
+    return true;
+}
+
+// 卸载共享库，之后不能再调用其中的函数
+void ScannerLibrary::unload() {
+    scanFunc = nullptr;
+    scanRangeFunc = nullptr;
+    ruleCountFunc = nullptr;
+    if (library.isLoaded())
+        library.unload();
+}
+
+// 共享库每得到一个单词调用一次，ctx 为调用者的单词数组
+void ScannerLibrary::putToken(void* ctx, int kind, size_t offset, size_t length) {
+    LexToken tok = {int32_t(kind), offset, length};
+    static_cast<vector<LexToken>*>(ctx)->push_back(tok);
+}
+
+/**
+ * @brief 调用共享库扫描输入
+ * @param data 输入
+ * @param size 输入的字节数
+ * @param [out] out 追加得到的单词
+ * @param threads 扫描的线程数，0 为硬件的线程数
+ * @return 没有出错返回 true；没有加载共享库时返回 false，out 不变
+ */
+bool ScannerLibrary::scan(const char* data, size_t size, vector<LexToken>& out, unsigned threads) const {
+    if (!isLoaded())
+        return false;
+    if (threads == 1) {
+        Sink sink = {&out, &ScannerLibrary::putToken};
+        return scanFunc(data, size, &sink) != 0;
+    }
+    ScanRangeFunc scanRange = scanRangeFunc;
+    auto scanPart = [scanRange, data, size](size_t from, size_t stop, vector<LexToken>& part) {
+        Sink sink = {&part, &ScannerLibrary::putToken};
+        return scanRange(data, size, from, stop, &sink) != 0;
+    };
+    return scanTokensParallel(scanPart, size, out, threads);
+}
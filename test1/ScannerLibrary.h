@@ -0,0 +1,45 @@
+#ifndef SCANNERLIBRARY_H
+#define SCANNERLIBRARY_H
+/*
+ * 文件名:ScannerLibrary.h
+ * 摘要：加载 genProgram(text, true) 生成并编译的共享库，在进程内调用其中的扫描函数
+ *
+ * 共享库导出 C 接口 scan、scan_range 和 scan_rule_count（见 WordAnal::genLibraryPrologue），
+ * 得到的单词与 scanTokens 相同，只记录规则序号和位置，由 WordAnal 的规则解释。
+ * 用 scan_range 在多个线程中分块扫描（scanTokensParallel），结果与一个线程相同。
+*/
+#include <QLibrary>
+#include "LexRuntime.h"
+
+class ScannerLibrary {
+public:
+    // 与生成的共享库中的 token_sink 布局相同
+    struct Sink {
+        void* ctx;
+        void (*put)(void* ctx, int kind, size_t offset, size_t length);
+    };
+    typedef int (*ScanFunc)(const char* data, size_t size, Sink* sink);
+    typedef int (*ScanRangeFunc)(const char* data, size_t size, size_t from, size_t stop, Sink* sink);
+    typedef int (*RuleCountFunc)();
+private:
+    QLibrary library;
+    ScanFunc scanFunc;
+    ScanRangeFunc scanRangeFunc;
+    RuleCountFunc ruleCountFunc;
+    static void putToken(void* ctx, int kind, size_t offset, size_t length);
+public:
+    ScannerLibrary() : scanFunc(nullptr), scanRangeFunc(nullptr), ruleCountFunc(nullptr) {}
+    ~ScannerLibrary() { unload(); }
+    ScannerLibrary(const ScannerLibrary&) = delete;
+    ScannerLibrary& operator=(const ScannerLibrary&) = delete;
+
+    bool load(const QString& fileName);     // 先卸载已加载的共享库
+    void unload();
+    bool isLoaded() const { return scanFunc != nullptr; }
+    QString getFileName() const { return library.fileName(); }
+    QString errorString() const { return library.errorString(); }
+    int getRuleCount() const { return ruleCountFunc ? ruleCountFunc() : -1; }
+
+    bool scan(const char* data, size_t size, vector<LexToken>& out, unsigned threads = 1) const;
+};
+#endif // SCANNERLIBRARY_H
@@ -0,0 +1,109 @@
+#ifndef STATESET_H
+#define STATESET_H
+/*
+ * 文件名:StateSet.h
+ * 摘要：NFA 状态号集合的稠密位集合实现，供子集构造和空边闭包使用
+ *
+ * 以 64 位字为单位存储，并集、相等比较和哈希都是按字循环，
+ * 便于编译器向量化；最高位的字总是非零，所以相同集合的存储完全一致。
+*/
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+// 统计 / 查找最低位 1 的辅助函数
+inline size_t bitCount(uint64_t w) {
+#ifdef __GNUC__
+    return __builtin_popcountll(w);
+#else
+    size_t n = 0;
+    for (; w; w &= w - 1) n++;
+    return n;
+#endif
+}
+inline size_t lowestBit(uint64_t w) {
+#ifdef __GNUC__
+    return __builtin_ctzll(w);
+#else
+    size_t n = 0;
+    while (!(w & 1)) { w >>= 1; n++; }
+    return n;
+#endif
+}
+
+class StateSet {
+private:
+    vector<uint64_t> words;  // 第 i 位表示状态号 i 是否在集合中
+public:
+    StateSet() {}
+    explicit StateSet(size_t id) { insert(id); }
+
+    void insert(size_t id) {
+        size_t w = id >> 6;
+        if (w >= words.size())
+            words.resize(w + 1, 0);
+        words[w] |= uint64_t(1) << (id & 63);
+    }
+    bool contains(size_t id) const {
+        size_t w = id >> 6;
+        return w < words.size() && ((words[w] >> (id & 63)) & 1);
+    }
+    // 并集：按字相或
+    void unite(const StateSet& s) {
+        if (s.words.size() > words.size())
+            words.resize(s.words.size(), 0);
+        const uint64_t* src = s.words.data();
+        uint64_t* dst = words.data();
+        for (size_t i = 0, n = s.words.size(); i < n; i++)
+            dst[i] |= src[i];
+    }
+    bool empty() const { return words.empty(); }
+    void clear() { words.clear(); }
+    size_t size() const {
+        size_t n = 0;
+        for (auto & w : words)
+            n += bitCount(w);
+        return n;
+    }
+    size_t bytes() const { return words.capacity() * sizeof(uint64_t); }   // 占用的字节数
+    size_t hash() const {
+        uint64_t h = 1469598103934665603ULL;  // FNV-1a，按字混合
+        for (auto & w : words) {
+            h ^= w;
+            h *= 1099511628211ULL;
+        }
+        return size_t(h ^ (h >> 32));
+    }
+    bool operator==(const StateSet& s) const { return words == s.words; }
+    bool operator!=(const StateSet& s) const { return words != s.words; }
+
+    // 按状态号从小到大遍历集合
+    class const_iterator {
+        const vector<uint64_t>* w;
+        size_t idx;     // 当前字的下标
+        uint64_t cur;   // 当前字中尚未遍历的位
+        void skip() {
+            while (cur == 0 && idx < w->size()) {
+                ++idx;
+                if (idx < w->size())
+                    cur = (*w)[idx];
+            }
+        }
+    public:
+        const_iterator(const vector<uint64_t>* _w, size_t _idx)
+            : w(_w), idx(_idx), cur(_idx < _w->size() ? (*_w)[_idx] : 0) { skip(); }
+        size_t operator*() const { return (idx << 6) + lowestBit(cur); }
+        const_iterator& operator++() { cur &= cur - 1; skip(); return *this; }
+        bool operator==(const const_iterator& it) const { return idx == it.idx && cur == it.cur; }
+        bool operator!=(const const_iterator& it) const { return !(*this == it); }
+    };
+    const_iterator begin() const { return const_iterator(&words, 0); }
+    const_iterator end() const { return const_iterator(&words, words.size()); }
+};
+
+// 供 unordered_map 等哈希容器使用
+struct StateSetHash {
+    size_t operator()(const StateSet& s) const { return s.hash(); }
+};
+#endif // STATESET_H
@@ -1,101 +1,228 @@
-#ifndef XFA_H
-#define XFA_H
-/*
- * 文件名:xfa.h
- * 摘要：完成 NFA DFA SDFA 的功能
- * 版本号:1
- * 作者:20202132039 刘梓扬
- * 日期:2023年4月1日
- *
- * 版本历史
- * 1 2023年4月1日    初始版本
-*/
-#include <QDebug>
-#include <iostream>
-#include <string>
-#include <QTextStream>
-
-#include <vector>
-#include <QStack>
-#include <queue>
-#include <set>
-#include <map>
-
-#include "Util.h"
-#include "BaseXFA.h"
-using namespace std;
-
-class WordAnal{
-private:
-    set<QString> ReservedWord;  // 保留字集合
-    bool IgnoreCase;        // 保留字是否忽略大小写，默认false
-    QString LineCommentSign;    // 行注释符号
-    QString BlockCommentBegin;  // 块注释开始符
-    QString BlockCommentEnd;    // 块注释结束符
-    QString varReservedWord;    // 保留字对应的变量名，从前面的varString中的一个
-    set<QString> SpecialSymbol; // 特殊符号
-    void setArgs(const QString& args); // 设置上面的私有变量
-    void setNfaArgs();
-    void clearArgs(); // 清除上面的私有变量
-    bool checkArgs(); // 检查上面的私有变量
-public:
-    WordAnal():transChar({}),NFAstates({}),DFAstates({}),SDFAstates({}) {}
-    // 把正则表达式转换为有限状态自动机
-    void parseExpressions(const QString& expstring, const WindowState state);
-    QStringList segment(const QString &exp); // 字符串转为token
-
-//  postfix
-private:
-    set<QString> transChar;// 转移字符集
-    set<QString> varString; // 变量string集
-
-    QStringList postfix(const QStringList &exp);  //正则表达式-->后缀表达式
-    QStringList AddConnectSymbol(const QStringList &exp); // 添加连接符 &
-    QStringList InfixToPostfix(const QStringList &exp);// 将中缀表达式转换成后缀表达式
-
-    size_t isp(const QString& oper);             // 栈内优先级
-    size_t icp(const QString& oper);             // 栈外优先级
-    bool isOperand(const QString& token);   // 是否为可以操作的字符: 大小写、数字、等号左边的变量
-    bool isOperator(const QString& token);    // 是否为运算字符
-    bool isUnaryOperator(const QString& token);    // 是否为单目运算符
-public:
-    set<QString> getTransChar() const {return transChar;}
-
-//  NFA
-private:
-    vector<NFAState> NFAstates;
-    set<size_t> endNFAState;
-    void addNfaRule(const QStringList& tokens, const QString& varName);
-    pair<size_t, size_t> CreateNFA(const QStringList &expression);    // 接收经过处理的后缀表达式，返回终态的id
-    void NFAprocess(QStack<Edge>& es, const QString& ch);
-    void checkEpEdge(size_t i);  // DFA之前更新各个状态空边集合
-public:
-    vector<NFAState> getNFAstates() const {return NFAstates;}
-
-//  DFA
-private:
-    vector<DFAState> DFAstates;
-    set<size_t> CreateDFA(const set<size_t> &endNFAState);
-    bool isFinal(size_t stateID,const set<size_t> &endNFAState);  // 检查是否为终态
-    size_t findVector(const set<size_t>& s) const;//查找是否在此数组,相当于set的find函数
-    set<size_t> getNextSet(const set<size_t>& s, const QString &ch);
-public:
-    vector<DFAState> getDFAstates() const {return DFAstates;}
-
-//  SDFA
-private:
-    vector<SDFAState> SDFAstates;
-    size_t SDFAstartID; // sdfa 的开始ID，CreateSDFA 函数会赋值
-    void CreateSDFA(const set<size_t>& endDFAState);
-    vector<set<size_t>> createPartSet(vector<map<QString, size_t>>& trans, const set<size_t>& endDFAState);
-    map<QString, set<size_t>> groupByVarName(const set<size_t>& endDFAState);
-    size_t FindSet(const Edge& e, const vector<set<size_t>>& partSet);
-public:
-    vector<SDFAState> getSDFAstates() const {return SDFAstates;}
-
-//    代码生成
-public:
-    void genProgram(QTextStream& text) const;
-};
-
-#endif // XFA_H
+#ifndef XFA_H
+#define XFA_H
+/*
+ * 文件名:xfa.h
+ * 摘要：完成 NFA DFA SDFA 的功能
+ * 版本号:1
+ * 作者:20202132039 刘梓扬
+ * 日期:2023年4月1日
+ *
+ * 版本历史
+ * 1 2023年4月1日    初始版本
+*/
+#include <QDebug>
+#include <iostream>
+#include <string>
+#include <QTextStream>
+
+#include <vector>
+#include <QStack>
+#include <queue>
+#include <set>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+
+#include "Util.h"
+#include "BaseXFA.h"
+#include "Automaton.h"
+#include "LexRuntime.h"
+using namespace std;
+
+// genProgram 生成的词法分析程序的形式
+enum ScannerStyle{
+    SwitchScanner,  // 每个状态一个 case，用 if / else if 比较字符
+    TableScanner,   // 按 [状态][等价类] 查压缩的转移表
+    DirectScanner   // 每个状态一个标号，用 goto 直接转移（re2c 风格）
+};
+
+// 最近一次用按需构造的 DFA（LazyDFA）扫描的统计
+struct LazyDFAStats {
+    size_t hits;        // 转移命中缓存的次数
+    size_t misses;      // 转移需要计算的次数
+    size_t flushes;     // 超过上限清空缓存的次数
+    size_t states;      // 扫描结束时缓存的状态数
+};
+
+class WordAnal{
+private:
+    set<QString> ReservedWord;  // 保留字集合
+    bool IgnoreCase;        // 保留字是否忽略大小写，默认false
+    QString LineCommentSign;    // 行注释符号
+    QString BlockCommentBegin;  // 块注释开始符
+    QString BlockCommentEnd;    // 块注释结束符
+    QString varReservedWord;    // 保留字对应的变量名，从前面的varString中的一个
+    set<QString> SpecialSymbol; // 特殊符号
+    ScannerStyle scannerStyle;  // 生成程序的形式，默认 SwitchScanner
+    bool batchMain;         // 生成的程序是否可以在线程池中批量扫描多个文件和目录，默认false
+    void setArgs(const QString& args); // 设置上面的私有变量
+    void setNfaArgs();
+    void clearArgs(); // 清除上面的私有变量
+    bool checkArgs(); // 检查上面的私有变量
+public:
+    WordAnal():scannerStyle(SwitchScanner),batchMain(false),transChar({}),classCount(0),subsetHits(0),subsetCreated(0),
+        maxDFAStates(10000),maxDFABytes(32 << 20),ruleDFAStates(0),ruleDFABytes(0),ruleLazyBytes(0),DFAoverflow(false) {}
+    // 把正则表达式转换为有限状态自动机
+    void parseExpressions(const QString& expstring, const WindowState state);
+    QStringList segment(const QString &exp); // 字符串转为token
+
+//  postfix
+private:
+    set<QString> transChar;// 转移字符集
+    set<QString> varString; // 变量string集
+
+    QStringList postfix(const QStringList &exp);  //正则表达式-->后缀表达式
+    QStringList AddConnectSymbol(const QStringList &exp); // 添加连接符 &
+    QStringList InfixToPostfix(const QStringList &exp);// 将中缀表达式转换成后缀表达式
+
+    size_t isp(const QString& oper);             // 栈内优先级
+    size_t icp(const QString& oper);             // 栈外优先级
+    bool isOperand(const QString& token);   // 是否为可以操作的字符: 大小写、数字、等号左边的变量
+    bool isOperator(const QString& token);    // 是否为运算字符
+    bool isUnaryOperator(const QString& token);    // 是否为单目运算符
+public:
+    set<QString> getTransChar() const {return transChar;}
+
+//  转移字符的符号 id 和字符等价类
+private:
+    vector<size_t> rankSym;     // 转移字符在 transChar 中的序号 -> 符号 id
+    vector<size_t> symRank;     // 符号 id -> 在 transChar 中的序号，不是转移字符时为 NO_EDGE
+    vector<size_t> charClass;   // 每个字节 (0~255) 所属的等价类 id
+    size_t classCount;          // 等价类的个数
+    vector<vector<size_t>> symClasses; // 每个转移字符（按符号 id）覆盖的等价类 id
+    void createTransSym();      // 在 postfix 收集完 transChar 之后为转移字符编号
+    void createCharClass();     // 在 postfix 收集完 transChar 之后计算字符等价类
+public:
+    const vector<size_t>& getRankSym() const {return rankSym;}
+    const vector<size_t>& getSymRank() const {return symRank;}
+    const vector<size_t>& getCharClass() const {return charClass;}
+    size_t getClassCount() const {return classCount;}
+    const vector<vector<size_t>>& getSymClasses() const {return symClasses;}
+
+//  NFA
+private:
+    Automaton NFAgraph;         // NFA 图，Thompson 构造结束后由 NFAedges 一次性压缩生成
+    vector<Edge> NFAedges;      // Thompson 构造过程中的边表，生成 NFAgraph 后释放
+    vector<int32_t> NFAaccept;  // Thompson 构造过程中各状态的规则序号，非终态为 -1
+    vector<uint32_t> epComp;    // NFA 状态 -> 所在空边强连通分量的编号
+    vector<StateSet> compClosure;   // 强连通分量 -> 空边闭包，同一分量中的状态共享同一个闭包
+    vector<QString> ruleNames;  // 规则序号 -> 变量名，序号越小优先级越高
+    vector<QStringList> rulePostfix;    // 规则序号 -> 后缀表达式
+    size_t newNfaState();       // 新建一个 NFA 状态，返回它的 id
+    void addNfaRule(const QStringList& tokens, const QString& varName);
+    void CreateNFAgraph();      // 由各条规则的后缀表达式构造 NFA 图
+    bool splitLiteralPrefix(const QStringList& postfix, QStringList& prefix, QStringList& rest);  // 拆出规则的字面前缀
+    pair<size_t, size_t> CreateNFA(const QStringList &expression);    // 接收经过处理的后缀表达式，返回终态的id
+    void NFAprocess(QStack<Edge>& es, const QString& ch);
+    void createEpClosure();     // DFA之前一次性计算各个状态的空边闭包
+    void fillState(State& st, const Automaton& graph, size_t id) const; // 从紧凑存储中取出一个状态
+public:
+    vector<NFAState> getNFAstates() const;
+    const Automaton& getNFAgraph() const {return NFAgraph;}
+    const StateSet& getEpClosure(size_t i) const {return compClosure[epComp[i]];}
+    const vector<QString>& getRuleNames() const {return ruleNames;}
+
+//  DFA
+private:
+    Automaton DFAgraph;
+    vector<StateSet> DFAsubsets;    // DFA 状态 -> NFA 子集，只在构造过程中保留
+    unordered_map<StateSet, size_t, StateSetHash> DFAindex; // NFA 子集 -> DFA 状态ID 的哈希索引，只在构造过程中保留
+    size_t subsetHits;      // 子集查找命中已有 DFA 状态的次数
+    size_t subsetCreated;   // 子集查找新建 DFA 状态的次数
+    size_t maxDFAStates;    // DFA 状态数的上限
+    size_t maxDFABytes;     // 子集构造占用内存的上限（字节）
+    size_t ruleDFAStates;   // 规则文本中 DFABudget 设置的状态数上限，0 为没有设置，使用 maxDFAStates
+    size_t ruleDFABytes;    // 规则文本中 DFABudget 设置的内存上限，0 为没有设置，使用 maxDFABytes
+    size_t ruleLazyBytes;   // 规则文本中 LazyDFACache 设置的 LazyDFA 缓存上限，0 为没有设置，使用 LazyDFA 的默认值
+    bool DFAoverflow;       // 子集构造是否超出了上限
+    set<size_t> CreateDFA();
+    int32_t acceptOf(const StateSet& s) const;  // 子集中终态的最小规则序号，不含终态返回 -1
+    size_t findVector(const StateSet& s) const;//查找是否在此数组,相当于set的find函数
+    map<size_t, StateSet> getNextSets(const StateSet& s);  // 子集在出边上各个转移字符下的下一跳子集
+public:
+    vector<DFAState> getDFAstates() const;
+    const Automaton& getDFAgraph() const {return DFAgraph;}
+    size_t getSubsetHits() const {return subsetHits;}
+    size_t getSubsetCreated() const {return subsetCreated;}
+    // 设置子集构造的状态数和内存上限，超出时改用位并行 NFA 模拟；规则文本中的 DFABudget 优先
+    void setDFABudget(size_t states, size_t bytes) {maxDFAStates = states; maxDFABytes = bytes;}
+    size_t getDFAStateBudget() const {return ruleDFAStates ? ruleDFAStates : maxDFAStates;}
+    size_t getDFAByteBudget() const {return ruleDFABytes ? ruleDFABytes : maxDFABytes;}
+    size_t getLazyCacheBytes() const {return ruleLazyBytes;}
+    bool isDFAOverflow() const {return DFAoverflow;}
+
+//  由后缀表达式直接构造 DFA（followpos 算法）
+private:
+    vector<size_t> posSym;      // 位置 -> 符号 id，规则的结束标记为 NO_EDGE
+    vector<int32_t> posRule;    // 位置 -> 规则序号，只有结束标记不为 -1
+    vector<StateSet> followPos; // 位置 -> followpos 集合
+    StateSet firstPos;          // 所有规则的 firstpos 之并，即初态的位置集合
+    size_t newPosition(size_t sym, int32_t rule);
+    size_t countPositions();       // 不建立 followpos，只数出 createFollowPos 会产生的位置数
+    void createFollowPos();     // 计算所有位置的 followpos 和初态的位置集合
+    set<size_t> CreateDirectDFA();
+    int32_t acceptOfPos(const StateSet& s) const;   // 位置集合中结束标记的最小规则序号
+public:
+    size_t getPositionCount() const {return posSym.size();}
+    const vector<size_t>& getPosSym() const {return posSym;}
+    const vector<int32_t>& getPosRule() const {return posRule;}
+    const vector<StateSet>& getFollowPos() const {return followPos;}
+    const StateSet& getFirstPos() const {return firstPos;}
+
+//  SDFA
+private:
+    Automaton SDFAgraph;    // 初态为 DFA 初态所在的划分
+    void CreateSDFA(const set<size_t>& endDFAState);
+    vector<set<size_t>> createPartSet(vector<map<size_t, size_t>>& trans, const set<size_t>& endDFAState);
+    map<QString, set<size_t>> groupByVarName(const set<size_t>& endDFAState);
+public:
+    vector<SDFAState> getSDFAstates() const;
+    const Automaton& getSDFAgraph() const {return SDFAgraph;}
+
+//    代码生成
+public:
+    void genProgram(QTextStream& text, bool sharedLibrary = false) const;  // 生成可执行程序或共享库的源程序
+    void genScannerHeader(QTextStream& text) const;    // 生成只有头文件、可重入的词法分析器
+    ScannerStyle getScannerStyle() const {return scannerStyle;}
+    QString tokenName(size_t rule) const;   // 规则在输出中的名字（去掉转义符）
+    // 确定的自动机按等价类展开的转移，没有转移为 -1
+    void buildTransitionRows(const Automaton& graph, vector<vector<int32_t>>& dense, vector<int32_t>& anyNext) const;
+private:
+    void genPrologue(QTextStream& text) const;      // 头文件、输入缓冲区、保留字数组、scanFile 的开始
+    void genReservedLookup(QTextStream& text) const;    // 按长度和首字符查找保留字的函数
+    void genSwitchScanner(QTextStream& text) const; // switch 形式的扫描循环
+    void genTableScanner(QTextStream& text) const;  // 表格驱动的扫描循环
+    void genDirectScanner(QTextStream& text) const; // 直接编码的扫描程序
+    void genEmitToken(QTextStream& text, size_t rule) const;    // 输出一个单词的代码
+    void genNoMatch(QTextStream& text, size_t id, const QString& restart) const; // 没有可走的转移时输出、回退或出错
+    void genEnterState(QTextStream& text, size_t target) const;     // 进入状态后跳过自环上的字节、记录最后经过的终态
+    bool isSkipState(size_t id) const;          // 状态是否有到自身的转移
+    void genSkipLoops(QTextStream& text) const; // 有自环的状态和初态空白字符的跳过函数
+    void genStreamOutput(QTextStream& text) const;  // 写出二进制单词流的函数
+    void genLineCounter(QTextStream& text) const;   // 统计一段文本中换行符的函数
+    QString skipSpaceCode(const QString& restart) const;    // 初态跳过空白字符的代码
+    static const char* const simdInclude;       // 跳过函数使用的 SIMD 头文件
+    void genEpilogue(QTextStream& text) const;      // scanFile 的结束和 main
+    void genMainStart(QTextStream& text) const;     // main 的开始：读入选项，扫描一个文件
+    void genMain(QTextStream& text) const;          // 只扫描一个文件的 main
+    void genBatchMain(QTextStream& text) const;     // 扫描一个文件，或者在线程池中批量扫描多个文件的 main
+    void genLibraryPrologue(QTextStream& text) const;   // 共享库的 C 接口、内存输入、scan 的开始
+    void genLibraryEpilogue(QTextStream& text) const;   // scan 的结束
+    void genTransitionTables(QTextStream& text) const;  // 行移位压缩的转移表和字符等价类
+
+//    进程内词法分析
+public:
+    // 用已构造的自动机扫描输入，用 LazyDFA 扫描时把命中、未命中和清空的次数写入 lazyStats
+    bool tokenize(const char* data, size_t size, vector<LexToken>& out, unsigned threads = 1,
+                  LazyDFAStats* lazyStats = nullptr) const;
+    // 在线程池中批量扫描多个文件，结果合并为一个带索引的文件
+    LexBatchStats tokenizeFiles(const QStringList& files, const QString& outPath, unsigned threads = 0) const;
+    QString tokenType(const char* data, const LexToken& tok) const;    // 单词的种别名，注释为空
+    // 按生成程序的输出格式写出单词序列，positions 为 true 时与 -l 选项相同，输出行号和列号
+    void writeTokens(QTextStream& text, const char* data, const vector<LexToken>& tokens, bool positions = false) const;
+    // 按二进制单词流的格式（LexRuntime.h）写出单词序列，varint 为 true 时用变长的差分编码
+    QByteArray tokenStream(const char* data, size_t size, const vector<LexToken>& tokens, bool varint) const;
+};
+
+#endif // XFA_H
@@ -1,127 +1,247 @@
-#include "WordAnal.h"
-#include "WordAnal.h"
-/**
-
-@brief 创建 NFA 图
-@param expression 后缀表达式
-@return pair<size_t, size_t> NFA 图的起点和终点
-@note 该函数会根据给定的后缀表达式 expression，创建对应的 NFA 图。
-首先初始化一个边栈 eStack，然后遍历后缀表达式中的每个字符 ch，根据 ch 的类型将边压入栈中。
-如果遍历结束后，栈的大小为 1，则将栈顶的边的尾部状态设为终点；
-否则，函数会输出错误信息。
-最后，函数将栈顶的边的头部状态和尾部状态作为 NFA 图的起点和终点，
-返回一个 pair 对象, 记录NFA 图的起点和终点。
-*/
-pair<size_t, size_t> WordAnal::CreateNFA(const QStringList &expression) {
-    QStack<Edge> eStack;  //记录存入栈的边
-    // 建立NFA图
-    for (auto &ch : expression)
-        NFAprocess(eStack, ch);
-    //经过上面的迭代，栈的大小应该为 1，确定终点
-    if (eStack.size() == 1) {
-        Edge e = eStack.top();
-        NFAstates[e.tail].setIsEnd(true);
-    } else{
-        qWarning("From CreateNFA(): edges Stack size() != 1 ");
-    }
-    return pair<size_t, size_t>(eStack.top().head, eStack.top().tail);
-}
-/**
- * @brief 对输入的字符进行正则表达式的NFA转换处理
- *
- * @param[in,out] eStack 存储NFA边的栈
- * @param[in] ch 输入的字符
- *
- * @return void
- *
- * @details
- * 如果输入的字符为 '&', 则从栈中弹出两条边，并新增两条边，将其中一条边推回栈中；
- * 否则，新增头尾两个节点，并根据输入字符类型，新增相应的边，并将新边入栈。
- *      - 如果输入的字符为'|', '*', '+', '?'中的一个，则从栈顶弹出若干条边，并新增相应的边，将新边 e 入栈。
- * @note
- * 该函数会修改 NFAstates 中的状态和边，因此在调用该函数之前，需要确保 NFAstates 中的状态和边是正确的。
- * 该函数需要使用一个 QStack<Edge> 类型的栈 eStack 来存储中间结果。需要先创建一个空的 eStack 栈，并将初始状态的边压入栈中。
- * 在调用该函数后，需要检查 eStack 栈中是否只剩下一条边，如果不是，则说明表达式存在错误，需要进行相应的错误处理。
- */
-void WordAnal::NFAprocess(QStack<Edge> &eStack, const QString &ch){
-    if (ch == '&') {  // 不需要加头尾结点，出栈1条边，新增2条边
-        Edge ne2 = eStack.pop();// ne1 ne2 出栈
-        Edge ne1 = eStack.pop();
-        Edge e1(ne1.tail, ne2.head);
-        Edge e(ne1.head, ne2.tail);
-        NFAstates[ne1.tail].addEdge(e1);
-        eStack.push(e);// e 入栈
-    } else {  // 运算符，新增头尾2个节点
-        NFAState h(NFAstates.size());
-        NFAstates.push_back(h);
-        NFAState t(NFAstates.size());
-        NFAstates.push_back(t);
-        size_t hid = h.getStateID(), tid = t.getStateID();
-        if (isOperand(ch)) {      // e 边有内容
-            Edge e(hid, tid, ch);  //新增一条边
-            NFAstates[NFAstates.size() - 2].addEdge(e);  // 更新
-            eStack.push(e);                       // e 入栈
-        } else {// 如果 e 是空边，则为普通符号 | * + ？
-            Edge e(hid, tid),
-                    ne = eStack.pop(),   // ne 出栈
-                    e1(hid, ne.head),
-                    e3(ne.tail, tid);
-            if (ch == '|') {  // 如果是 | 则出栈2条边，新建4条空边
-                Edge ne1 = eStack.pop(),
-                        e2(hid, ne1.head),
-                        e4(ne1.tail, tid);
-                h.addEdge(e2);
-                NFAstates[ne1.tail].addEdge(e4);
-            } else { // 如果是 * + ? 则出栈1条边，新建3条空边
-                Edge e2(ne.tail, ne.head);
-                if(ch!='+')
-                    h.addEdge(e);
-                if(ch!='?')
-                    NFAstates[ne.tail].addEdge(e2);
-            }
-            h.addEdge(e1);
-            NFAstates[ne.tail].addEdge(e3);
-            NFAstates[NFAstates.size() - 2] = h;  //更新
-            eStack.push(e);                       // e 入栈
-        }
-    }
-}
-/**
- * @brief 更新 NFA 图中各个状态的空边集合
- *
- * @param i 状态编号
- * @note 该函数会从给定的状态 i 开始，遍历所有可以通过空边到达的状态，并将这些状态的编号添加到 i 状态的空边集合中。
- *
- * 具体的实现方法为：首先初始化已访问状态集合和状态栈；
- * 然后将状态 i 压入状态栈中，并循环处理状态栈中的状态，直到栈为空。
- * 在处理每个状态时，函数会将该状态标记为已访问，并更新它的空边集合。
- * 然后遍历该状态的空边指向的所有状态，如果这些状态未被访问，则将它们压入状态栈中并标记为已访问。
- * 最后，将空边指向的状态的空边集合添加到当前状态的空边集合中。
- */
-void WordAnal::checkEpEdge(size_t i) {
-    set<size_t> visited;// 初始化已访问状态集合
-    QStack<size_t> stateStack;// 初始化状态栈
-    stateStack.push(i);//并将当前状态压入栈中
-
-    // 循环处理状态栈中的状态，直到栈为空
-    while (!stateStack.empty()) {
-        size_t stateIndex = stateStack.pop();// 取出栈顶状态
-        visited.insert(stateIndex);// 并标记为已访问
-
-        // 更新当前状态的空边集合
-        NFAstates[i].insertEpTrans(stateIndex);
-
-        // 处理当前状态的空边指向的所有状态
-        for (auto& epEdge : NFAstates[stateIndex].getEpTrans()) {
-            // 如果空边指向的状态未被访问，则将其入栈并标记为已访问
-            if (visited.find(epEdge) == visited.end()) {
-                stateStack.push(epEdge);
-                visited.insert(epEdge);
-            }
-            // 将空边指向的状态的空边集合添加到当前状态的空边集合中
-            for (auto& it : NFAstates[epEdge].getEpTrans())
-                NFAstates[i].insertEpTrans(it);
-        }
-    }
-}
-
+#include "WordAnal.h"
+/**
+ * @brief 由各条规则的后缀表达式构造 NFA 图
+ * @note 0 号状态为初态。每条规则开头的字面前缀（特殊符号、注释开始符、纯字面的规则）
+ * 合并成一棵从 0 号状态出发的前缀树，共同的前缀只有一条路径：
+ *      - 纯字面的规则，前缀树的叶子（或中间结点）直接记录规则序号，
+ *        同一个结点上有多条规则时保留序号最小的，与子集构造时取最小规则序号的优先级一致
+ *      - 有字面前缀的规则，其余部分用 Thompson 构造，用空边挂在前缀的末尾
+ *      - 没有字面前缀的规则，和原来一样用空边连接到 0 号状态
+ * 这样运算符很多的语言不会在初态上挂几百条空边，子集构造中的空边闭包也小得多。
+ * 构造过程中只向边表追加，结束后把边表压缩为 NFAgraph，释放构造用的边表。
+ */
+void WordAnal::CreateNFAgraph() {
+    newNfaState();  // 0 号为 NFA 的初态，也是前缀树的根
+    map<pair<size_t, QString>, size_t> trie;    // <前缀树结点, 符号> -> 子结点
+    for (size_t i = 0; i < rulePostfix.size(); i++) {
+        QStringList prefix, rest;
+        if (!splitLiteralPrefix(rulePostfix[i], prefix, rest)) {
+            pair<size_t,size_t> ansNFA = CreateNFA(rulePostfix[i]);
+            NFAedges.push_back(Edge(0,ansNFA.first));
+            NFAaccept[ansNFA.second] = int32_t(i);
+            continue;
+        }
+        size_t node = 0;
+        for (auto & sym : prefix) {
+            auto it = trie.find(make_pair(node, sym));
+            if (it == trie.end()) {
+                size_t child = newNfaState();
+                NFAedges.push_back(Edge(node, child, sym));
+                it = trie.insert(make_pair(make_pair(node, sym), child)).first;
+            }
+            node = it->second;
+        }
+        if (rest.empty()) {     // 纯字面的规则
+            if (NFAaccept[node] < 0)
+                NFAaccept[node] = int32_t(i);
+            continue;
+        }
+        pair<size_t,size_t> ansNFA = CreateNFA(rest);
+        NFAedges.push_back(Edge(node,ansNFA.first));
+        NFAaccept[ansNFA.second] = int32_t(i);
+    }
+    NFAgraph.assign(NFAaccept, NFAedges, 0);
+    vector<Edge>().swap(NFAedges);
+    vector<int32_t>().swap(NFAaccept);
+}
+
+/**
+ * @brief 把规则的后缀表达式拆成字面前缀和其余部分
+ * @param postfix 规则的后缀表达式
+ * @param [out] prefix 开头连续的单个符号（不含 epsilon）
+ * @param [out] rest 其余部分的后缀表达式，纯字面的规则为空
+ * @return 有字面前缀返回 true
+ * @details 用一个栈自底向上求出每个子表达式在后缀表达式中的范围，
+ * 连接运算 & 的结果记录为各个因子的列表，这样整个表达式的最外层连接被展开成因子序列 F1 F2 ... Fn。
+ * 前面只由一个符号组成的因子就是字面前缀，剩下的因子按 Fk Fk+1 & ... Fn & 重新组成后缀表达式。
+ * 后缀表达式不合法时返回 false，由 CreateNFA 按原样处理。
+ */
+bool WordAnal::splitLiteralPrefix(const QStringList& postfix, QStringList& prefix, QStringList& rest) {
+    typedef pair<int, int> Span;    // 子表达式在 postfix 中的范围 [first, second)
+    vector<vector<Span>> fStack;    // 每个子表达式的最外层连接因子
+    for (int i = 0; i < postfix.size(); i++) {
+        const QString& ch = postfix[i];
+        if (isOperand(ch)) {
+            fStack.push_back(vector<Span>(1, Span(i, i + 1)));
+            continue;
+        }
+        bool binary = (ch == "&" || ch == "|");
+        if (fStack.size() < (binary ? 2u : 1u))
+            return false;
+        if (ch == "&") {
+            vector<Span> right = fStack.back();
+            fStack.pop_back();
+            fStack.back().insert(fStack.back().end(), right.begin(), right.end());
+            continue;
+        }
+        if (binary)
+            fStack.pop_back();
+        int first = fStack.back().front().first;
+        fStack.back().assign(1, Span(first, i + 1));
+    }
+    if (fStack.size() != 1)
+        return false;
+    const vector<Span>& factors = fStack.back();
+    size_t k = 0;
+    for (; k < factors.size(); k++) {
+        const Span& f = factors[k];
+        if (f.second - f.first != 1 || postfix[f.first] == epsilon)
+            break;
+        prefix << postfix[f.first];
+    }
+    for (size_t j = k; j < factors.size(); j++) {
+        rest << postfix.mid(factors[j].first, factors[j].second - factors[j].first);
+        if (j > k)
+            rest << "&";
+    }
+    return k > 0;
+}
+#include "WordAnal.h"
+/**
+
+@brief 创建 NFA 图
+@param expression 后缀表达式
+@return pair<size_t, size_t> NFA 图的起点和终点
+@note 该函数会根据给定的后缀表达式 expression，创建对应的 NFA 图。
+首先初始化一个边栈 eStack，然后遍历后缀表达式中的每个字符 ch，根据 ch 的类型将边压入栈中。
+如果遍历结束后，栈的大小不为 1，函数会输出错误信息；
+终点的规则序号由调用者 CreateNFAgraph 记录。
+最后，函数将栈顶的边的头部状态和尾部状态作为 NFA 图的起点和终点，
+返回一个 pair 对象, 记录NFA 图的起点和终点。
+*/
+pair<size_t, size_t> WordAnal::CreateNFA(const QStringList &expression) {
+    QStack<Edge> eStack;  //记录存入栈的边
+    // 建立NFA图
+    for (auto &ch : expression)
+        NFAprocess(eStack, ch);
+    //经过上面的迭代，栈的大小应该为 1，确定终点
+    if (eStack.size() != 1)
+        qWarning("From CreateNFA(): edges Stack size() != 1 ");
+    return pair<size_t, size_t>(eStack.top().head, eStack.top().tail);
+}
+/**
+ * @brief 对输入的字符进行正则表达式的NFA转换处理
+ *
+ * @param[in,out] eStack 存储NFA边的栈
+ * @param[in] ch 输入的字符
+ *
+ * @return void
+ *
+ * @details
+ * 如果输入的字符为 '&', 则从栈中弹出两条边，并新增两条边，将其中一条边推回栈中；
+ * 否则，新增头尾两个节点，并根据输入字符类型，新增相应的边，并将新边入栈。
+ *      - 如果输入的字符为'|', '*', '+', '?'中的一个，则从栈顶弹出若干条边，并新增相应的边，将新边 e 入栈。
+ * @note
+ * 该函数只向 NFAaccept 追加新状态、向边表 NFAedges 追加新边，不会复制已有的状态。
+ * 该函数需要使用一个 QStack<Edge> 类型的栈 eStack 来存储中间结果。需要先创建一个空的 eStack 栈，并将初始状态的边压入栈中。
+ * 在调用该函数后，需要检查 eStack 栈中是否只剩下一条边，如果不是，则说明表达式存在错误，需要进行相应的错误处理。
+ */
+void WordAnal::NFAprocess(QStack<Edge> &eStack, const QString &ch){
+    if (ch == '&') {  // 不需要加头尾结点，出栈1条边，新增2条边
+        Edge ne2 = eStack.pop();// ne1 ne2 出栈
+        Edge ne1 = eStack.pop();
+        Edge e1(ne1.tail, ne2.head);
+        Edge e(ne1.head, ne2.tail);
+        NFAedges.push_back(e1);
+        eStack.push(e);// e 入栈
+    } else {  // 运算符，新增头尾2个节点
+        size_t hid = newNfaState(), tid = newNfaState();
+        if (isOperand(ch)) {      // e 边有内容
+            Edge e(hid, tid, ch);  //新增一条边
+            NFAedges.push_back(e);
+            eStack.push(e);                       // e 入栈
+        } else {// 如果 e 是空边，则为普通符号 | * + ？
+            Edge e(hid, tid),
+                    ne = eStack.pop(),   // ne 出栈
+                    e1(hid, ne.head),
+                    e3(ne.tail, tid);
+            if (ch == '|') {  // 如果是 | 则出栈2条边，新建4条空边
+                Edge ne1 = eStack.pop(),
+                        e2(hid, ne1.head),
+                        e4(ne1.tail, tid);
+                NFAedges.push_back(e2);
+                NFAedges.push_back(e4);
+            } else { // 如果是 * + ? 则出栈1条边，新建3条空边
+                Edge e2(ne.tail, ne.head);
+                if(ch!='+')
+                    NFAedges.push_back(e);
+                if(ch!='?')
+                    NFAedges.push_back(e2);
+            }
+            NFAedges.push_back(e1);
+            NFAedges.push_back(e3);
+            eStack.push(e);                       // e 入栈
+        }
+    }
+}
+/**
+ * @brief 一次性计算 NFA 图中所有状态的空边闭包
+ *
+ * @note 空边图中同一个强连通分量内的状态互相可达，闭包完全相同，因此按分量计算并共享。
+ *
+ * 具体的实现方法为：用非递归的 Tarjan 算法求空边图的强连通分量，
+ * Tarjan 算法按逆拓扑序（先汇点后源点）产生分量，
+ * 所以一个分量出栈时，它经过空边能到达的其他分量都已经算好了闭包，
+ * 该分量的闭包 = 分量内的状态 ∪ 这些后继分量的闭包，按字并入即可。
+ * 结果中 epComp[i] 为状态 i 所在的分量，compClosure 为各分量的闭包，
+ * 整个过程只遍历每条空边常数次。
+ */
+void WordAnal::createEpClosure() {
+    const uint32_t UNVISITED = UINT32_MAX;
+    size_t n = NFAgraph.size();
+    vector<uint32_t> index(n, UNVISITED), low(n, 0);
+    vector<char> onStack(n, 0);
+    vector<uint32_t> sccStack;                  // Tarjan 的状态栈
+    vector<pair<uint32_t, uint32_t>> callStack; // 模拟递归：<状态, 下一条待访问空边的序号>
+    uint32_t counter = 0;
+    epComp.assign(n, 0);
+    compClosure.clear();
+
+    for (size_t root = 0; root < n; root++) {
+        if (index[root] != UNVISITED)
+            continue;
+        index[root] = low[root] = counter++;
+        sccStack.push_back(uint32_t(root));
+        onStack[root] = 1;
+        callStack.push_back(make_pair(uint32_t(root), uint32_t(0)));
+        while (!callStack.empty()) {
+            uint32_t v = callStack.back().first;
+            Range<uint32_t> epEdges = NFAgraph.getEpEdges(v);
+            if (callStack.back().second < epEdges.size()) {
+                uint32_t w = epEdges.b[callStack.back().second++];
+                if (index[w] == UNVISITED) {    // 未访问，进入下一层
+                    index[w] = low[w] = counter++;
+                    sccStack.push_back(w);
+                    onStack[w] = 1;
+                    callStack.push_back(make_pair(w, uint32_t(0)));
+                } else if (onStack[w])
+                    low[v] = min(low[v], index[w]);
+                continue;
+            }
+            // v 的空边都已访问，返回上一层
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                uint32_t u = callStack.back().first;
+                low[u] = min(low[u], low[v]);
+            }
+            if (low[v] != index[v])
+                continue;
+            // v 是分量的根，出栈整个分量并计算它的闭包
+            uint32_t comp = uint32_t(compClosure.size());
+            compClosure.push_back(StateSet());
+            StateSet& closure = compClosure.back();
+            size_t bottom = sccStack.size();
+            do {
+                bottom--;
+                onStack[sccStack[bottom]] = 0;
+                epComp[sccStack[bottom]] = comp;
+                closure.insert(sccStack[bottom]);
+            } while (sccStack[bottom] != v);
+            for (size_t i = bottom; i < sccStack.size(); i++)
+                for (auto w : NFAgraph.getEpEdges(sccStack[i]))
+                    if (epComp[w] != comp)  // 其他分量一定已经完成
+                        closure.unite(compClosure[epComp[w]]);
+            sccStack.resize(bottom);
+        }
+    }
+}
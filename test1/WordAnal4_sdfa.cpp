@@ -1,143 +1,189 @@
-#include "WordAnal.h"
-/**
-
-@brief 从 DFA 生成 SDFA
-@param endDFAState DFA 的终止状态集合
-@note 该函数会根据类成员变量DFAstates 中存储的 DFA状态,创建对应的 SDFA。
-1. 调用 createPartSet 函数创建 SDFA 的划分集合 partSet;
-2. 根据每个划分集合,创建对应的 SDFA 状态,设置初始状态、终止状态和变量名;
-3. 根据 trans 数组,创建 SDFA 状态之间的边，将边添加到对应的 SDFA 状态。
-4. SDFA 状态和边就创建完成,存储在类成员变量 SDFAstates 中。
-*/
-void WordAnal::CreateSDFA(const set<size_t>& endDFAState) {
-    vector<map<QString, size_t>> trans;  //存储partSet的边<值，dest>
-    vector<set<size_t>> partSet = createPartSet(trans,endDFAState); //用于存储所有的划分集合
-
-    vector<Edge> tmpEdges;
-    for (size_t i = 0; i < partSet.size(); i++) {
-        set<size_t> currPartset = partSet[i];
-        if(!currPartset.size())
-            continue;
-
-        SDFAState tmpSDFA(currPartset, i);
-        //新建对应的边
-        for (auto & itChar : transChar)
-            if (trans[i][itChar] != NO_EDGE) {
-                Edge ne(i, trans[i][itChar], itChar);
-                tmpEdges.push_back(ne);
-            }
-        // 初态判断
-        if (partSet[i].find(0) != partSet[i].end()){
-            tmpSDFA.setIsStart(true);
-            SDFAstartID = i;
-        }
-        // 终态判断
-        for (auto & it : partSet[i])
-            for (auto & it1 : endDFAState)
-                if (it == it1) {
-                    tmpSDFA.setIsEnd(true);
-                    tmpSDFA.setVarName(DFAstates[it1].getVarName());
-                    break;
-                }
-        SDFAstates.push_back(tmpSDFA);
-    }
-    //将状态添加对应的边
-    for (auto & it: tmpEdges)
-        SDFAstates[it.head].addEdge(it);
-}
-
-/**
-@brief 从 DFA 中创建 SDFA 的划分集合
-@param endDFAState DFA 的终止状态集合
-@return vector<set<size_t>> SDFA 的划分集合
-@note 该函数会根据类成员变量 DFAstates 中存储的 DFA 状态,创建 SDFA 的划分集。
-首先根据 DFA 终止状态,将 DFA 状态划分为若干个终止状态集合和一个非终止状态集合;
-对于每个 DFA 状态,如果输入符号对应的边导致划分集合数量增加,则进行新的划分;
-循环执行上一步骤,直到不会再进行新的划分。
-最终返回得到的所有划分集合。
-在创建划分集的过程中,trans 变量用来记录每个终结符对应的划分集合。
-*/
-vector<set<size_t>> WordAnal::createPartSet(vector<map<QString, size_t>> &trans,const set<size_t>& endDFAState) {
-    vector<set<size_t>> partSet;
-    map<size_t, set<size_t>> tmpSet;  // <转移到的partset，源partset>
-    bool hasEdge;  //判断该DFA状态是否存在与该终结符对应的弧
-
-    //遍历DFA状态数组,将不同的终态和非终态划分开
-    for(auto & it : groupByVarName(endDFAState))
-        partSet.push_back(it.second);  //终态集
-    size_t firstNon = partSet.size();
-    partSet.push_back({});
-    for (auto & itDFA :  DFAstates) {// 遍历每个DFA状态
-        if (!itDFA.getIsEnd())  //如果该DFA状态不是终态
-            partSet[firstNon].insert(itDFA.getStateID());  //加入到最后一个划分集合中
-
-        bool cutflag = true;  //上次是否产生新的划分
-        while (cutflag) {  //一直循环，直到上次没有产生新的划分
-            int cutCount;  //划分次数
-            for (size_t i = 0; i < partSet.size(); i++) {// 遍历每个划分集合partSet
-                cutCount = 0;
-                trans.push_back({});
-
-                for (auto & itChar : transChar) {// 遍历每个终结符
-                    tmpSet.clear();
-                    for (auto & itStateID: partSet[i]) {// 遍历集合partSet[i]中的每个DFAstate
-                        hasEdge = false;
-                        for (auto& edge : DFAstates[itStateID].getEdges()) // 遍历state的每条边
-                            if (edge.Value == itChar) {// 如果存在某条边的输入为当前终结符
-                                size_t setId = FindSet(edge, partSet);//找到该弧转换到的状态所属的划分集合id
-                                tmpSet[setId].insert(itStateID); //将该DFAstate的ID加入到缓冲区中能转换到setId的状态集合中
-                                hasEdge = true;
-                                break;
-                            }
-                        if (!hasEdge)
-                            tmpSet[NO_EDGE].insert(itStateID);
-                    }
-
-                    auto itMap = tmpSet.begin();
-                    if (tmpSet.size() > 1) {// 缓冲区中元素个数大于1，则需要划分
-                        cutCount++;        // 划分次数 +1
-                        for (itMap++; itMap != tmpSet.end(); itMap++) {// 从1开始，要将temp[0]中的元素保留在原划分集合中
-                            partSet.push_back(itMap->second);  // 创建新的划分集合
-                            for (auto & it : itMap->second) // 删除原划分集合partSet中temp[i] 中的元素
-                                partSet[i].erase(it);
-                        }
-                    }  //否则无需划分，记录对应的tmpSet
-                    else if (tmpSet.size() == 1)
-                        trans[i][itChar] = itMap->first;//创建新边
-                } // transChar
-            } // partSet
-            cutflag = cutCount;  //划分次数大于0说明本次产生了新的划分
-        }
-    }
-    return partSet;
-}
-
-/**
-@brief 将终态集合按照变量名分组
-@param endDFAState DFA终态的集合
-@return map<QString, set<size_t>> 返回按照变量名分组的结果
-*/
-map<QString, set<size_t>> WordAnal::groupByVarName(const set<size_t> &endDFAState) {
-    map<QString, set<size_t>> res;
-    for(auto& it : endDFAState){
-        QString str = DFAstates[it].getVarName();
-        res[str].insert(it);
-    }
-    return res;
-}
-
-/**
- * @brief 找到该弧转换到的状态所属的划分的 id集合
- * @param e 一条DFA边
- * @param partSet DFA状态的划分集合
- * @return size_t 该弧转换到的状态所属的划分的 id集合
-*/
-size_t WordAnal::FindSet(const Edge& e, const vector<set<size_t>>& partSet) {
-    size_t res = 0;
-    for (; res < partSet.size(); res++) {//遍历各个划分
-        for (auto& it: partSet[res])//遍历划分内的每个状态
-            if (it == e.tail)
-                return res;
-    }
-    return res;
-}
+#include "WordAnal.h"
+/**
+
+@brief 从 DFA 生成 SDFA
+@param endDFAState DFA 的终止状态集合
+@note 该函数会根据 DFA 图 DFAgraph,创建对应的 SDFA 图 SDFAgraph。
+1. 调用 createPartSet 函数创建 SDFA 的划分集合 partSet;
+2. 按编号顺序为每个划分集合追加一个 SDFA 状态,终态取划分中任一 DFA 终态的规则序号;
+3. 根据 trans 数组中实际存在的边,追加该 SDFA 状态的出边;
+4. 包含 DFA 初态 0 的划分作为 SDFA 的初态。
+*/
+void WordAnal::CreateSDFA(const set<size_t>& endDFAState) {
+    vector<map<size_t, size_t>> trans;  //存储partSet的边<转移字符序号，dest>
+    vector<set<size_t>> partSet = createPartSet(trans,endDFAState); //用于存储所有的划分集合
+
+    for (size_t i = 0; i < partSet.size(); i++) {
+        // 终态判断，同一划分中的终态变量名相同
+        int32_t accept = -1;
+        for (auto & it : partSet[i])
+            if (endDFAState.count(it)) {
+                accept = DFAgraph.getAccept(it);
+                break;
+            }
+        SDFAgraph.addState(accept);
+        //新建对应的边，trans 中只记录了实际存在的边
+        for (auto & itTrans : trans[i])
+            if (itTrans.second != NO_EDGE)
+                SDFAgraph.addEdge(rankSym[itTrans.first], itTrans.second);
+        // 初态判断
+        if (partSet[i].count(0))
+            SDFAgraph.setStart(i);
+    }
+    SDFAgraph.shrink();
+}
+
+/**
+@brief 从 DFA 中创建 SDFA 的划分集合
+@param trans 输出参数,记录每个划分集合在其出边的终结符(transChar 中的序号)下转移到的划分集合
+@param endDFAState DFA 的终止状态集合
+@return vector<set<size_t>> SDFA 的划分集合
+@note 该函数使用 Hopcroft 划分细化算法创建 SDFA 的划分集,时间复杂度 O(n·k·log n)。
+1. 初始划分:按变量名分组的终态集合和非终态集合;
+2. 用 blockOf 记录每个状态所属的划分,用反向边表 inv 找到能经过某个终结符转移到划分 A 的状态,
+   以 (划分, 终结符) 为分割器放入工作表,每次取出一个分割器,标记它的前驱并分割被部分标记的划分;
+   被分割的划分如果已在工作表中,则两半都加入,否则只加入较小的一半;
+3. DFA 的转移是部分函数,缺少的边不会被任何分割器标记,
+   因此只要初始时把所有划分都放入工作表,"没有边"和"有边"的状态就会被区分开,不需要补充死状态;
+4. 工作表为空时得到最终划分,按划分内最小的 DFA 状态号排序输出,
+   并根据每个划分中任一状态的出边填写 trans,只记录实际存在的边。
+*/
+vector<set<size_t>> WordAnal::createPartSet(vector<map<size_t, size_t>> &trans,const set<size_t>& endDFAState) {
+    size_t n = DFAgraph.size();
+    size_t k = rankSym.size();  // 终结符按 transChar 中的序号编号
+
+    // 反向边表，inv[invStart[t] .. invStart[t+1]) 为到达 t 的所有边 <终结符, 源状态>，按终结符排序
+    vector<size_t> invStart(n + 1, 0);
+    for (size_t s = 0; s < n; s++)
+        for (auto & edge : DFAgraph.getEdges(s))
+            invStart[edge.tail + 1]++;
+    for (size_t i = 1; i <= n; i++)
+        invStart[i] += invStart[i - 1];
+    vector<pair<size_t, size_t>> inv(invStart[n]);
+    vector<size_t> fill(invStart.begin(), invStart.end() - 1);
+    for (size_t s = 0; s < n; s++)
+        for (auto & edge : DFAgraph.getEdges(s))
+            inv[fill[edge.tail]++] = make_pair(symRank[edge.sym], s);
+    for (size_t t = 0; t < n; t++)
+        sort(inv.begin() + invStart[t], inv.begin() + invStart[t + 1]);
+
+    // 划分:elems 中每个划分占据连续的一段 [first, last)，被标记的元素放在段首
+    vector<size_t> elems, loc(n), blockOf(n);
+    vector<size_t> first, last, marked;
+    auto addBlock = [&](const vector<size_t>& states) {
+        size_t b = first.size();
+        first.push_back(elems.size());
+        for (auto s : states) {
+            loc[s] = elems.size();
+            blockOf[s] = b;
+            elems.push_back(s);
+        }
+        last.push_back(elems.size());
+        marked.push_back(0);
+    };
+    for (auto & it : groupByVarName(endDFAState))    //终态集,按变量名分组
+        addBlock(vector<size_t>(it.second.begin(), it.second.end()));
+    vector<size_t> nonEnd;
+    for (size_t s = 0; s < n; s++)
+        if (!DFAgraph.isEnd(s))
+            nonEnd.push_back(s);
+    if (!nonEnd.empty())
+        addBlock(nonEnd);   //非终态集
+
+    // 工作表:(划分, 终结符) 分割器；inWork 记录分割器是否已在工作表中
+    vector<pair<size_t, size_t>> work;
+    vector<char> inWork;
+    for (size_t b = 0; b < first.size(); b++)
+        for (size_t c = 0; c < k; c++) {
+            work.push_back({b, c});
+            inWork.push_back(1);
+        }
+
+    vector<size_t> splitter, touched;
+    while (!work.empty()) {
+        size_t A = work.back().first, c = work.back().second;
+        work.pop_back();
+        inWork[A * k + c] = 0;
+
+        // 标记所有经过 c 能到达 A 的状态
+        splitter.assign(elems.begin() + first[A], elems.begin() + last[A]);
+        touched.clear();
+        for (auto t : splitter) {
+            auto range = equal_range(inv.begin() + invStart[t], inv.begin() + invStart[t + 1],
+                                     make_pair(c, size_t(0)),
+                                     [](const pair<size_t, size_t>& x, const pair<size_t, size_t>& y) { return x.first < y.first; });
+            for (auto it = range.first; it != range.second; ++it) {
+                size_t s = it->second, b = blockOf[s];
+                size_t pos = first[b] + marked[b];
+                if (loc[s] < pos)   // 已经标记过
+                    continue;
+                size_t other = elems[pos];  // 把 s 交换到已标记段的末尾
+                elems[pos] = s;
+                elems[loc[s]] = other;
+                loc[other] = loc[s];
+                loc[s] = pos;
+                if (marked[b]++ == 0)
+                    touched.push_back(b);
+            }
+        }
+
+        // 分割被部分标记的划分，已标记的部分成为新划分
+        for (auto b : touched) {
+            size_t m = marked[b];
+            marked[b] = 0;
+            if (m == last[b] - first[b])
+                continue;
+            size_t nb = first.size();
+            first.push_back(first[b]);
+            last.push_back(first[b] + m);
+            marked.push_back(0);
+            first[b] += m;
+            for (size_t i = first[nb]; i < last[nb]; i++)
+                blockOf[elems[i]] = nb;
+            inWork.resize(first.size() * k, 0);
+            for (size_t ch = 0; ch < k; ch++) {
+                size_t add = nb;
+                if (!inWork[b * k + ch] && last[b] - first[b] < m)
+                    add = b;    // 原划分不在工作表中，只加入较小的一半
+                inWork[add * k + ch] = 1;
+                work.push_back({add, ch});
+            }
+        }
+    }
+
+    // 按划分内最小的 DFA 状态号排序
+    vector<size_t> order(first.size());
+    vector<size_t> minState(first.size(), SIZE_MAX);
+    for (size_t s = 0; s < n; s++)
+        minState[blockOf[s]] = min(minState[blockOf[s]], s);
+    for (size_t b = 0; b < first.size(); b++)
+        order[b] = b;
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) { return minState[a] < minState[b]; });
+    vector<size_t> newId(first.size());
+    for (size_t i = 0; i < order.size(); i++)
+        newId[order[i]] = i;
+
+    vector<set<size_t>> partSet(order.size());
+    trans.assign(order.size(), {});
+    for (size_t i = 0; i < order.size(); i++) {
+        size_t b = order[i];
+        partSet[i].insert(elems.begin() + first[b], elems.begin() + last[b]);
+        for (auto & edge : DFAgraph.getEdges(elems[first[b]]))
+            trans[i][symRank[edge.sym]] = newId[blockOf[edge.tail]];
+    }
+    return partSet;
+}
+
+/**
+@brief 将终态集合按照变量名分组
+@param endDFAState DFA终态的集合
+@return map<QString, set<size_t>> 返回按照变量名分组的结果
+*/
+map<QString, set<size_t>> WordAnal::groupByVarName(const set<size_t> &endDFAState) {
+    map<QString, set<size_t>> res;
+    for(auto& it : endDFAState){
+        QString str = ruleNames[DFAgraph.getAccept(it)];
+        res[str].insert(it);
+    }
+    return res;
+}
@@ -0,0 +1,184 @@
+#include "WordAnal.h"
+/**
+ * @brief 新建一个位置
+ * @param sym 位置上的符号 id，规则的结束标记为 NO_EDGE
+ * @param rule 结束标记对应的规则序号，普通位置为 -1
+ * @return 新位置的编号
+ */
+size_t WordAnal::newPosition(size_t sym, int32_t rule) {
+    posSym.push_back(sym);
+    posRule.push_back(rule);
+    followPos.push_back(StateSet());
+    return posSym.size() - 1;
+}
+
+/**
+ * @brief 由各条规则的后缀表达式计算所有位置的 followpos
+ * @note 结果记录在 posSym、posRule、followPos 中，所有规则的 firstpos 之并记录在 firstPos 中，
+ * 即 DFA 初态对应的位置集合。
+ *
+ * @details
+ * 后缀表达式就是语法树的后序遍历，用一个片段栈自底向上计算每个子树的
+ * nullable / firstpos / lastpos，同时填写 followpos：
+ *      - 操作数 a：新建一个位置 p，firstpos = lastpos = {p}；epsilon 可空，两个集合为空
+ *      - 连接 c1 & c2：lastpos(c1) 中每个位置的 followpos 并入 firstpos(c2)
+ *      - * 和 +：lastpos 中每个位置的 followpos 并入自身的 firstpos
+ *      - | 和 ?：只合并集合和 nullable
+ * 每条规则的末尾再连接一个带规则序号的结束标记，所有规则之间是"或"的关系。
+ * @note 后缀表达式不合法（栈中片段不足）时输出错误信息并跳过该规则
+ */
+/**
+ * @brief 数出 createFollowPos 会产生的位置数：每个非 epsilon 的操作数一个，每条规则的结束标记一个
+ * @note followpos 表占用 O(n^2) 位，先用这个数判断位置是否放得下，再决定是否建立
+ */
+size_t WordAnal::countPositions() {
+    size_t n = rulePostfix.size();
+    for (auto & postfix : rulePostfix)
+        for (auto & ch : postfix)
+            if (isOperand(ch) && ch != epsilon)
+                n++;
+    return n;
+}
+
+void WordAnal::createFollowPos() {
+    struct Fragment {
+        bool nullable;
+        StateSet first;
+        StateSet last;
+    };
+    posSym.clear();
+    posRule.clear();
+    followPos.clear();
+    firstPos.clear();
+    for (size_t rule = 0; rule < rulePostfix.size(); rule++) {
+        vector<Fragment> fStack;
+        bool valid = true;
+        for (auto & ch : rulePostfix[rule]) {
+            if (isOperand(ch)) {
+                Fragment f;
+                f.nullable = (ch == epsilon);
+                if (!f.nullable) {
+                    size_t p = newPosition(SymbolTable::instance().intern(ch), -1);
+                    f.first.insert(p);
+                    f.last.insert(p);
+                }
+                fStack.push_back(f);
+                continue;
+            }
+            bool binary = (ch == "&" || ch == "|");
+            if (fStack.size() < (binary ? 2u : 1u)) {
+                valid = false;
+                break;
+            }
+            if (binary) {
+                Fragment f2 = fStack.back();
+                fStack.pop_back();
+                Fragment& f1 = fStack.back();
+                if (ch == "&") {
+                    for (auto p : f1.last)
+                        followPos[p].unite(f2.first);
+                    if (f1.nullable)
+                        f1.first.unite(f2.first);
+                    if (f2.nullable)
+                        f1.last.unite(f2.last);
+                    else
+                        f1.last = f2.last;
+                    f1.nullable = f1.nullable && f2.nullable;
+                } else {
+                    f1.first.unite(f2.first);
+                    f1.last.unite(f2.last);
+                    f1.nullable = f1.nullable || f2.nullable;
+                }
+            } else {
+                Fragment& f = fStack.back();
+                if (ch != "?")  // * +
+                    for (auto p : f.last)
+                        followPos[p].unite(f.first);
+                if (ch != "+")  // * ?
+                    f.nullable = true;
+            }
+        }
+        if (!valid || fStack.size() != 1) {
+            qWarning() << "From createFollowPos(): invalid postfix of rule" << ruleNames[rule];
+            continue;
+        }
+        // 连接本规则的结束标记
+        Fragment& f = fStack.back();
+        size_t endPos = newPosition(NO_EDGE, int32_t(rule));
+        for (auto p : f.last)
+            followPos[p].insert(endPos);
+        firstPos.unite(f.first);
+        if (f.nullable)
+            firstPos.insert(endPos);
+    }
+}
+
+/**
+@brief 由后缀表达式直接构造 DFA，不经过 NFA 和空边闭包
+@return set<size_t> DFA 的终止状态集合
+@note 每个 DFA 状态对应一个位置集合，初态为所有规则的 firstpos 之并。
+对于每个位置集合，只遍历其中实际出现的输入符号，
+符号 a 下的下一状态为集合中所有符号为 a 的位置的 followpos 之并。
+子集的查找和登记与 CreateDFA 共用 DFAsubsets、DFAindex 和命中统计，
+结果存放在 DFAgraph 中，可以和 CreateDFA 的结果直接比较。
+集合中含有结束标记的状态为终态，规则序号取最小的结束标记。
+*/
+set<size_t> WordAnal::CreateDirectDFA() {
+    set<size_t> end;        // DFA的终态id集合
+    vector<int32_t> accept; // 已发现的 DFA 状态的规则序号
+    queue<size_t> qSubset;  // 子集队列 DFA状态ID
+
+    createFollowPos();
+    DFAsubsets.push_back(firstPos);// 添加初态
+    DFAindex[firstPos] = 0;
+    accept.push_back(acceptOfPos(firstPos));
+    qSubset.push(0);
+
+    while (!qSubset.empty()) {
+        size_t topID = qSubset.front();
+        qSubset.pop();
+        DFAgraph.addState(accept[topID]);
+        if (accept[topID] >= 0)
+            end.insert(topID);
+
+        // 按 transChar 的序号合并各个位置的 followpos
+        map<size_t, StateSet> nextSets;
+        for (auto p : DFAsubsets[topID])
+            if (posSym[p] < symRank.size() && symRank[posSym[p]] != NO_EDGE)
+                nextSets[symRank[posSym[p]]].unite(followPos[p]);
+        for (auto & itNext : nextSets) {
+            const StateSet& nextSet = itNext.second;
+            if (nextSet.empty())
+                continue;
+            size_t resfind = findVector(nextSet);
+            if (resfind == DFAsubsets.size()) {  // 如果是新的子集
+                subsetCreated++;
+                DFAsubsets.push_back(nextSet);
+                DFAindex[nextSet] = resfind;
+                accept.push_back(acceptOfPos(nextSet));
+                qSubset.push(resfind);
+            } else
+                subsetHits++;
+            DFAgraph.addEdge(rankSym[itNext.first], resfind);
+        }
+    }
+    // 释放构造用的子集和索引
+    vector<StateSet>().swap(DFAsubsets);
+    unordered_map<StateSet, size_t, StateSetHash>().swap(DFAindex);
+    vector<StateSet>().swap(followPos);
+    DFAgraph.shrink();
+    return end;
+}
+
+/**
+@brief 判断位置集合对应的 DFA 状态是否为终态
+@param s 位置集合
+@return int32_t 集合中结束标记的最小规则序号，不含结束标记返回 -1
+*/
+int32_t WordAnal::acceptOfPos(const StateSet& s) const {
+    int32_t res = -1;
+    for (auto p : s)
+        if (posRule[p] >= 0 && (res < 0 || posRule[p] < res))
+            res = posRule[p];
+    return res;
+}
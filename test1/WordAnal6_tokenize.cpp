@@ -0,0 +1,229 @@
+#include "WordAnal.h"
+#include "SDFAMatcher.h"
+#include "LazyDFA.h"
+#include "BitParallelNFA.h"
+#include <QFile>
+#include <QFileInfo>
+#include <memory>
+
+/**
+ * @brief 不生成程序，直接在进程内对输入进行词法分析
+ * @param data 输入
+ * @param size 输入的字节数
+ * @param [out] out 追加得到的单词
+ * @param threads 扫描的线程数，0 为硬件的线程数
+ * @param [out] lazyStats 不为空并且用 LazyDFA 扫描时，写入它的命中、未命中和清空缓存的次数，否则不变
+ * @return 没有出错返回 true；规则还没有解析到可以扫描的阶段（如只构造了 NFA）时返回 false，out 不变
+ * @note 按最近一次 parseExpressions 得到的结果选择自动机：
+ *      - 有 SDFA 时解释执行 SDFA 的转移表（SDFAMatcher）
+ *      - DFA 超出预算时用位并行 NFA 模拟（BitParallelNFA）
+ *      - 只构造了 DFA（dfa、directDfa）时解释执行 DFA 的转移表
+ *      - lazyDfa 时按需构造 DFA（LazyDFA）
+ * 扫描规则与生成的程序相同（scanTokens），单词序列用 writeTokens 写出后与程序的输出一致。
+ * 解释执行 SDFA、DFA 的转移表时可以分块并行扫描（scanTokensParallel），结果与一个线程相同；
+ * BitParallelNFA 和 LazyDFA 在扫描时修改自身的状态，总是在一个线程中扫描。
+ */
+bool WordAnal::tokenize(const char* data, size_t size, vector<LexToken>& out, unsigned threads,
+                        LazyDFAStats* lazyStats) const {
+    if (!SDFAgraph.empty() || (!DFAoverflow && !DFAgraph.empty())) {
+        SDFAMatcher m(*this, SDFAgraph.empty() ? DFAgraph : SDFAgraph);
+        auto scanRange = [&m, data, size](size_t from, size_t stop, vector<LexToken>& part) {
+            return scanTokens(m, data, size, part, from, stop);
+        };
+        return scanTokensParallel(scanRange, size, out, threads);
+    }
+    if (DFAoverflow) {
+        BitParallelNFA m(*this);
+        return scanTokens(m, data, size, out);
+    }
+    if (!charClass.empty() && !NFAgraph.empty()) {
+        LazyDFA m(*this, getLazyCacheBytes() ? getLazyCacheBytes() : LazyDFA::DEFAULT_BUDGET);
+        bool ok = scanTokens(m, data, size, out);
+        if (lazyStats) {
+            LazyDFAStats stats = {m.getHits(), m.getMisses(), m.getFlushes(), m.getStateCount()};
+            *lazyStats = stats;
+        }
+        return ok;
+    }
+    qWarning() << "From tokenize(): the expressions have not been parsed to an automaton";
+    return false;
+}
+
+/**
+ * @brief 批量词法分析：在线程池中同时扫描多个文件，结果按文件的顺序合并为一个带索引的文件
+ * @param files 输入文件
+ * @param outPath 合并的输出文件，格式与生成的程序的 -m 选项相同（genBatchMain）：
+ *      第一行 "LEXINDEX 文件数"，然后每个文件一行 "起点\t字节数\t路径"（起点从索引之后算起），最后是各个文件的单词
+ * @param threads 线程数，0 为硬件的线程数
+ * @return 文件数、打不开或者有出错单词的文件数（与生成的程序的批量 main 的统计相同）、读入的总字节数；
+ * 输出文件打不开时所有文件都算作出错
+ * @note 线程池为 runWorkStealing，大的文件先分配。有 SDFA、DFA 时所有线程共用一份转移表（SDFAMatcher 是只读的），
+ * 否则每个文件调用 tokenize。文件的打开方式与生成的程序的 fopen(..., "r") 相同：
+ * Windows 上按文本方式读入，把 \r\n 当作 \n；其他系统按原样读入，\r 仍然是输入的一部分。
+ * 每个文件的单词用 writeTokens 写出，与生成的程序对这个文件的输出相同。
+ */
+LexBatchStats WordAnal::tokenizeFiles(const QStringList& files, const QString& outPath, unsigned threads) const {
+    const size_t count = size_t(files.size());
+    LexBatchStats stats = {count, 0, 0};
+    if (threads == 0)
+        threads = max(thread::hardware_concurrency(), 1u);
+    unique_ptr<SDFAMatcher> shared;
+    if (!SDFAgraph.empty() || (!DFAoverflow && !DFAgraph.empty()))
+        shared.reset(new SDFAMatcher(*this, SDFAgraph.empty() ? DFAgraph : SDFAgraph));
+
+    // 大的文件先扫描
+    vector<size_t> order(count);
+    vector<qint64> fileSize(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+        fileSize[i] = QFileInfo(files[int(i)]).size();
+    }
+    stable_sort(order.begin(), order.end(), [&fileSize](size_t a, size_t b) { return fileSize[a] > fileSize[b]; });
+    vector<QByteArray> outputs(count);
+    vector<char> failed(count, 1);
+    vector<uint64_t> bytes(count, 0);
+#ifdef Q_OS_WIN
+    const QIODevice::OpenMode mode = QIODevice::ReadOnly | QIODevice::Text;
+#else
+    const QIODevice::OpenMode mode = QIODevice::ReadOnly;
+#endif
+    runWorkStealing(count, threads, [&](size_t job) {
+        size_t i = order[job];
+        QFile file(files[int(i)]);
+        if (!file.open(mode))
+            return;
+        QByteArray data = file.readAll();
+        vector<LexToken> tokens;
+        bool ok = shared ? scanTokens(*shared, data.constData(), size_t(data.size()), tokens)
+                         : tokenize(data.constData(), size_t(data.size()), tokens);
+        QString text;
+        QTextStream stream(&text);
+        writeTokens(stream, data.constData(), tokens);
+        stream.flush();
+        outputs[i] = text.toUtf8();
+        failed[i] = !ok;
+        bytes[i] = uint64_t(data.size());
+    });
+
+    for (size_t i = 0; i < count; i++) {
+        stats.failed += size_t(failed[i]);
+        stats.bytes += bytes[i];
+    }
+    QFile out(outPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qWarning() << "From tokenizeFiles(): can't open" << outPath;
+        stats.failed = count;
+        return stats;
+    }
+    QByteArray index = "LEXINDEX " + QByteArray::number(qulonglong(count)) + "\n";
+    qulonglong offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        index += QByteArray::number(offset) + '\t' + QByteArray::number(outputs[i].size()) + '\t'
+                 + files[int(i)].toUtf8() + '\n';
+        offset += qulonglong(outputs[i].size());
+    }
+    out.write(index);
+    for (auto & output : outputs)
+        out.write(output);
+    return stats;
+}
+
+/**
+ * @brief 单词在输出中的种别名
+ * @param data 扫描的输入，单词的文本取自其中
+ * @param tok 一个单词
+ * @return 出错的单词为 ErrorState；注释（BlockComment、LineComment）返回空字符串，表示不输出；
+ * 变量名为 varReservedWord 的单词如果是保留字，返回保留字的大写（IgnoreCase 时不区分大小写）；
+ * 其它单词返回 tokenName，即去掉特殊符号转义（如 \*）的变量名，与生成的程序一致。
+ */
+QString WordAnal::tokenType(const char* data, const LexToken& tok) const {
+    if (tok.kind == LEX_ERROR)
+        return "ErrorState";
+    const QString& varName = ruleNames[tok.kind];
+    if (varName == "BlockComment" || varName == "LineComment")
+        return "";
+    if (varName == varReservedWord) {
+        QString word = QString::fromUtf8(data + tok.offset, int(tok.length));
+        if (IgnoreCase)
+            word = word.toLower();
+        if (ReservedWord.count(word))
+            return word.toUpper();
+    }
+    return tokenName(tok.kind);
+}
+
+/**
+ * @brief 按照生成程序的输出格式写出单词序列
+ * @param [in, out] text 输出流
+ * @param data 扫描的输入，单词的文本取自其中
+ * @param tokens scanTokens 得到的单词序列
+ * @param positions 是否在种别名之后输出 "\t行号:列号"，与生成的程序的 -l 选项相同
+ * @note 每个单词输出一行"文本\t种别名"，种别名由 tokenType 决定，为空的注释不输出；
+ * 出错的单词输出"文本\tErrorState"，与生成的程序一样不换行。
+ * 行号和列号由 LexLineCounter 按单词的顺序统计两个单词之间的换行符得到，不输出的注释中的换行符也一起统计。
+ */
+void WordAnal::writeTokens(QTextStream& text, const char* data, const vector<LexToken>& tokens, bool positions) const {
+    LexLineCounter lines(data);
+    for (auto & tok : tokens) {
+        QString type = tokenType(data, tok);
+        if (type.isEmpty())
+            continue;
+        text << QString::fromUtf8(data + tok.offset, int(tok.length)) << '\t' << type;
+        if (positions) {
+            LexPosition at = lines.at(tok.offset);
+            text << '\t' << qulonglong(at.line) << ':' << qulonglong(at.column);
+        }
+        if (tok.kind != LEX_ERROR)
+            text << endl;
+    }
+}
+
+/**
+ * @brief 按二进制单词流的格式写出单词序列，与生成的程序 -b（定长记录）、-B（varint 为 true）选项的输出相同
+ * @param data 扫描的输入，整个写入单词流作为源文本
+ * @param size 输入的字节数
+ * @param tokens scanTokens 得到的单词序列
+ * @param varint 单词记录是否用变长的差分编码
+ * @return 单词流的全部内容；定长记录而输入超过 LEXB_FIXED_MAX 字节时起点和长度放不下，返回空
+ * @note 种别字典依次为各条规则的 tokenName、大写的保留字（与 genReservedLookup 中 ReservedUpper 的顺序相同）
+ * 和 ErrorState，单词的种别与 tokenType 相同，注释不写出。
+ */
+QByteArray WordAnal::tokenStream(const char* data, size_t size, const vector<LexToken>& tokens, bool varint) const {
+    vector<string> kinds;
+    for (size_t rule = 0; rule < ruleNames.size(); rule++)
+        kinds.push_back(tokenName(rule).toUtf8().toStdString());
+    map<QString, uint32_t> reservedKind;
+    for (auto & word : ReservedWord) {
+        if (word.isEmpty())
+            continue;
+        reservedKind[word] = uint32_t(kinds.size());
+        kinds.push_back(word.toUpper().toUtf8().toStdString());
+    }
+    const uint32_t errorKind = uint32_t(kinds.size());
+    kinds.push_back("ErrorState");
+
+    LexStreamWriter writer;
+    if (!writer.begin(kinds, data, size, varint)) {
+        qWarning() << "From tokenStream(): the input is too large for fixed-size records, use varint records";
+        return QByteArray();
+    }
+    for (auto & tok : tokens) {
+        if (tok.kind == LEX_ERROR) {
+            writer.put(errorKind, tok.offset, tok.length);
+            continue;
+        }
+        const QString& varName = ruleNames[tok.kind];
+        if (varName == "BlockComment" || varName == "LineComment")
+            continue;
+        uint32_t kind = uint32_t(tok.kind);
+        if (varName == varReservedWord) {
+            QString word = QString::fromUtf8(data + tok.offset, int(tok.length));
+            auto it = reservedKind.find(IgnoreCase ? word.toLower() : word);
+            if (it != reservedKind.end())
+                kind = it->second;
+        }
+        writer.put(kind, tok.offset, tok.length);
+    }
+    const string& stream = writer.finish();
+    return QByteArray(stream.data(), int(stream.size()));
+}
@@ -0,0 +1,886 @@
+#include "WordAnal.h"
+
+// 输出一个单词之后，下一个单词的起点到了要扫描的范围之外时结束（共享库的 scan_range，可执行程序中总是 false）
+static const char* const stopCheck = "if(in.done()) goto lex_done;";
+
+// 没有可走的转移且当前不是终态时，退回到最后一次经过的终态，输出那个单词
+static const char* const rollBack =
+        "in.pos = in.tok + lastLen; putRule(out, in, lastRule); in.tok = in.pos; lastRule = -1; if(in.done()) goto lex_done;";
+
+// 跳过函数使用的 SIMD 指令集：GCC / Clang 在目标支持 SSE2 或 AVX2 时使用，定义 LEX_NO_SIMD 可以关闭
+const char* const WordAnal::simdInclude =
+        "#if !defined(LEX_NO_SIMD) && defined(__GNUC__) && (defined(__SSE2__) || defined(__AVX2__))\n"
+        "#include <immintrin.h>\n"
+        "#define LEX_SIMD 1\n"
+        "#endif\n";
+
+// 把字符串写成 C 的字符串字面量
+static QString quoted(QString str) {
+    str.replace("\\", "\\\\").replace("\"", "\\\"");
+    return "\"" + str + "\"";
+}
+
+/**
+ * @brief 根据 SDFA 自动机的状态生成词法分析器的代码
+ * @param [in, out] text 输出的代码流
+ * @note 该函数会根据已经构建好的 SDFA 和 ReservedWord，生成一个 C++ 代码的词法分析器程序。
+ * 该程序按块读入文件，对每个字符根据 SDFA 进行状态转移，当前单词只记录为缓冲区中的 [tok, pos) 一段，
+ * 单词跨越块的边界时把已读入的部分移到缓冲区的开头，不为每个单词分配内存。
+ * 如果读入的字符可以转移到终止状态，那么对应的单词和终止状态的名称会被写入输出缓冲区。
+ * 如果读入的字符无法转移至任何状态，那么会将已经读入的单词记录为错误，并停止处理。
+ * 输入结束时，如果停在终态，输出最后一个单词，否则把没有读完的部分记录为错误（与 scanTokens 一致）。
+ * 每个文件的输出缓冲区在最后一次性写入文件。扫描代码在 scanFile 函数中，main 扫描一个文件（genMain）；
+ * 规则中有 BatchMain 参数时，main 还可以在线程池中批量扫描多个文件和目录（genBatchMain）。
+ * 程序的形式由规则中的 ScannerStyle 参数决定：
+ *      - switch（默认）：每个状态一个 case，用 if / else if 比较字符
+ *      - table：按 [状态][等价类] 查转移表，表格用行移位法压缩
+ *      - direct：每个状态一个标号，用 goto 直接转移
+ * 各种形式的输出完全相同。
+ * sharedLibrary 为 true 时生成共享库而不是可执行程序，扫描代码相同，只是开始和结束部分不同（genLibraryPrologue）。
+*/
+void WordAnal::genProgram(QTextStream& text, bool sharedLibrary) const {
+    if(SDFAgraph.empty())
+        return ;
+    if(sharedLibrary)
+        genLibraryPrologue(text);
+    else
+        genPrologue(text);
+    if(scannerStyle == TableScanner)
+        genTableScanner(text);
+    else if(scannerStyle == DirectScanner)
+        genDirectScanner(text);
+    else
+        genSwitchScanner(text);
+    if(sharedLibrary)
+        genLibraryEpilogue(text);
+    else
+        genEpilogue(text);
+}
+
+// 程序的开始部分：头文件、输入缓冲区、输出单词的函数、保留字的查找、规则名的数组、扫描一个文件的函数的开始
+// 当前单词经过的最后一个终态记录在 lastRule（规则序号，没有为 -1）和 lastLen（单词在那里的长度）中
+void WordAnal::genPrologue(QTextStream& text) const {
+    text << "#include <cstdio>\n"
+            "#include <cstring>\n"
+            "#include <cstdlib>\n"
+            "#include <cstdint>\n"
+            "#include <string>\n"
+            "#include <vector>\n"
+            "#include <algorithm>\n"
+            "using namespace std;\n";
+    text << simdInclude;
+    // trackLines 由 main 按 -l 选项设置，之后只读
+    text << "static bool trackLines = false;\n";
+    genLineCounter(text);
+    // 按块读入的输入缓冲区，[tok, pos) 为当前单词；base 为移出缓冲区的字节数，单词流中的起点为 base + tok
+    // 行号：counted 之前的换行符已经统计，line 为 counted 所在的行，lineStart 为这一行的起点（都是在整个文件中的位置）
+    text << "struct LexInput {\n"
+            "FILE* f; vector<char> buf; size_t tok, pos, lim;\n"
+            "uint64_t base, count, lastEnd;\n"
+            "uint64_t counted, lineStart; unsigned long line; bool failed;\n"
+            "explicit LexInput(FILE* file) : f(file), buf(1 << 16), tok(0), pos(0), lim(0), base(0), count(0), lastEnd(0),\n"
+            "counted(0), lineStart(0), line(1), failed(false) {}\n"
+            "bool more() { return pos < lim || fill(); }\n"
+            "const char* cur() const { return &buf[0] + pos; }\n"
+            "bool done() const { return false; }\n"
+            "void countTo(size_t to) {\n"
+            "size_t from = size_t(counted - base), after = 0;\n"
+            "size_t n = countLines(&buf[0] + from, to - from, after);\n"
+            "if (n) { line += n; lineStart = base + from + after; }\n"
+            "counted = base + to;\n"
+            "}\n"
+            "bool fill() {\n"
+            "if (trackLines) countTo(tok);\n"
+            "size_t keep = lim - tok;\n"
+            "if (keep) memmove(&buf[0], &buf[tok], keep);\n"
+            "base += tok; pos -= tok; lim = keep; tok = 0;\n"
+            "if (keep > buf.size() / 2) buf.resize(buf.size() * 2);\n"
+            "lim += fread(&buf[lim], 1, buf.size() - lim, f);\n"
+            "return pos < lim;\n"
+            "}\n"
+            "};\n";
+    // -l 时在种别名之后输出单词起点的行号和列号
+    text << "static void putToken(string& out, LexInput& in, const char* name) {\n"
+            "out.append(&in.buf[0] + in.tok, in.pos - in.tok); out += '\\t'; out += name;\n"
+            "if (trackLines) {\n"
+            "in.countTo(in.tok);\n"
+            "char at[48]; int n = snprintf(at, sizeof at, \"\\t%lu:%lu\", in.line, (unsigned long)(in.base + in.tok - in.lineStart + 1));\n"
+            "out.append(at, size_t(n));\n"
+            "}\n"
+            "}\n";
+    genReservedLookup(text);
+    // 保留字输出为大写，其它单词输出变量名
+    text << "static void putReserved(string& out, LexInput& in, const char* name) {\n"
+            "int i = reservedIndex(&in.buf[in.tok], in.pos - in.tok);\n"
+            "putToken(out, in, i >= 0 ? ReservedUpper[i] : name); out += '\\n';\n"
+            "}\n";
+    // 规则的输出名和类型（0 普通，1 注释不输出，2 保留字变量），回退时按规则序号输出单词
+    text << "static const char* const tokName[" << max<size_t>(ruleNames.size(), 1) << "] = {";
+    QStringList flags;
+    for(size_t rule = 0; rule < ruleNames.size(); rule++){
+        text << (rule ? ", " : "") << quoted(tokenName(rule));
+        const QString& varName = ruleNames[rule];
+        if(varName == "BlockComment" || varName == "LineComment")
+            flags << "1";
+        else if(varName == varReservedWord)
+            flags << "2";
+        else
+            flags << "0";
+    }
+    if(ruleNames.empty()){
+        text << "\"\"";
+        flags << "0";
+    }
+    text << "};\n"
+            "static const unsigned char tokFlag[" << flags.size() << "] = {" << flags.join(",") << "};\n";
+    genStreamOutput(text);
+    text << "static void putRule(string& out, LexInput& in, int rule) {\n"
+            "if (outFormat) {\n"
+            "if (tokFlag[rule] == 1) return;\n"
+            "int r = tokFlag[rule] == 2 ? reservedIndex(&in.buf[in.tok], in.pos - in.tok) : -1;\n"
+            "putRecord(out, in, r >= 0 ? ruleCount + unsigned(r) : unsigned(rule));\n"
+            "}\n"
+            "else if (tokFlag[rule] == 2) putReserved(out, in, tokName[rule]);\n"
+            "else if (tokFlag[rule] == 0) {putToken(out, in, tokName[rule]); out += '\\n';}\n"
+            "}\n";
+    text << "static void putError(string& out, LexInput& in) {\n"
+            "in.failed = true;\n"
+            "if (outFormat) putRecord(out, in, ruleCount + reservedCount);\n"
+            "else putToken(out, in, \"ErrorState\");\n"
+            "}\n";
+    genSkipLoops(text);
+    // 扫描一个打开的文件，单词追加到 out 中，返回单词流中的单词数，failed 不为空时写入是否有出错的单词；
+    // 只读的表都是全局的，多个线程可以同时调用
+    text << "static uint64_t scanFile(FILE* fin, string& out, bool* failed = 0) {\n"
+            "LexInput in(fin);\n"
+            "char ch;\n"
+            "int lastRule = -1; size_t lastLen = 0;\n";
+}
+
+// 程序的结束部分：scanFile 的结束（出错时扫描代码直接跳到 lex_done），然后是 main，有 BatchMain 参数时可以批量扫描
+void WordAnal::genEpilogue(QTextStream& text) const {
+    text << "lex_done:\n"
+            "if (failed) *failed = in.failed;\n"
+            "return in.count;\n}\n";
+    if(batchMain)
+        genBatchMain(text);
+    else
+        genMain(text);
+}
+
+/**
+ * @brief 生成写出二进制单词流（格式见 LexRuntime.h）的代码
+ * @note outFormat 由 main 按 -b / -B 选项设置，之后只读：0 为文本，1 为定长记录，2 为变长的差分编码。
+ * 单词流格式时 putRule、putError 调用 putRecord 把单词记录追加到 out 中，扫描完一个文件后 makeStream
+ * 重新读入这个文件作为源文本，在记录前面加上文件头、种别字典和源文本。
+ * 定长记录的起点和长度为 u32，源文本超过 4 GB 时 makeStream 返回 false，main 报错并把这个文件算作失败。
+ * 种别字典依次为 tokName、ReservedUpper 和 ErrorState，与 WordAnal::tokenStream 相同。
+*/
+void WordAnal::genStreamOutput(QTextStream& text) const {
+    size_t reservedCount = 0;
+    for(auto & word : ReservedWord)
+        if(!word.isEmpty())
+            reservedCount++;
+    text << "static int outFormat = 0;\n"
+            "static const unsigned ruleCount = " << ruleNames.size() << ", reservedCount = " << reservedCount << ";\n"
+            "static void putFixed(string& out, uint64_t v, int bytes) { for (int i = 0; i < bytes; i++) out += char(v >> (8 * i) & 0xff); }\n"
+            "static void putVarint(string& out, uint64_t v) { for (; v >= 0x80; v >>= 7) out += char((v & 0x7f) | 0x80); out += char(v); }\n"
+            "static void putRecord(string& out, LexInput& in, unsigned kind) {\n"
+            "uint64_t offset = in.base + in.tok, length = in.pos - in.tok;\n"
+            "if (outFormat == 2) { putVarint(out, kind); putVarint(out, offset - in.lastEnd); putVarint(out, length); }\n"
+            "else { putFixed(out, kind, 4); putFixed(out, offset, 4); putFixed(out, length, 4); }\n"
+            "in.lastEnd = offset + length; in.count++;\n"
+            "}\n"
+            "static bool makeStream(FILE* fin, string& out, uint64_t count) {\n"
+            "string head(\"LEXB\\1\");\n"
+            "head += char(outFormat == 2 ? 1 : 0); putFixed(head, 0, 2);\n"
+            "putFixed(head, ruleCount + reservedCount + 1, 4); putFixed(head, count, 8);\n"
+            "size_t sizePos = head.size(); putFixed(head, 0, 8);\n"
+            "for (unsigned k = 0; k <= ruleCount + reservedCount; k++) {\n"
+            "const char* name = k < ruleCount ? tokName[k] : k < ruleCount + reservedCount ? ReservedUpper[k - ruleCount] : \"ErrorState\";\n"
+            "size_t len = strlen(name); putFixed(head, len, 2); head.append(name, len);\n"
+            "}\n"
+            "size_t textPos = head.size(); char chunk[1 << 16]; size_t n;\n"
+            "rewind(fin);\n"
+            "while ((n = fread(chunk, 1, sizeof chunk, fin)) > 0) head.append(chunk, n);\n"
+            "if (outFormat == 1 && uint64_t(head.size() - textPos) > 0xffffffffu) { out.clear(); return false; }\n"
+            "for (int i = 0; i < 8; i++) head[sizePos + i] = char(uint64_t(head.size() - textPos) >> (8 * i) & 0xff);\n"
+            "head += out; out.swap(head);\n"
+            "return true;\n"
+            "}\n";
+}
+
+/**
+ * @brief 共享库的开始部分：C 接口的声明、内存中的输入、交给调用者的单词、scan_range 函数的开始
+ * @note 生成的共享库导出三个 C 函数：
+ *      - int scan(const char* data, size_t size, token_sink* sink)：扫描 [data, data + size)，
+ *        每个单词调用一次 sink->put(sink->ctx, 规则序号, 起点, 长度)，出错的单词规则序号为 -1，没有出错返回 1
+ *      - int scan_range(const char* data, size_t size, size_t from, size_t stop, token_sink* sink)：
+ *        把 from 当作一个单词的起点开始扫描，下一个单词的起点不小于 stop 时停止，与 scanTokens 的 from / stop 相同，
+ *        供调用者分块并行扫描（scanTokensParallel）；scan 即 scan_range(data, size, 0, size, sink)
+ *      - int scan_rule_count()：规则的个数，调用者用来检查规则序号与自己的规则是否一致
+ * 输入整块在内存中，in.more() 不再读文件；除了只读的表以外没有全局状态，可以在多个线程中同时调用。
+ * 保留字的替换、注释的过滤和输出名都由调用者按规则序号处理（WordAnal::tokenType），
+ * 所以这里没有保留字表和规则名的数组。
+*/
+void WordAnal::genLibraryPrologue(QTextStream& text) const {
+    text << "#include <cstddef>\n"
+            "#include <cstring>\n"
+            "#if defined(_WIN32)\n"
+            "#define LEX_EXPORT extern \"C\" __declspec(dllexport)\n"
+            "#else\n"
+            "#define LEX_EXPORT extern \"C\" __attribute__((visibility(\"default\")))\n"
+            "#endif\n";
+    text << simdInclude;
+    text << "struct token_sink { void* ctx; void (*put)(void* ctx, int kind, size_t offset, size_t length); };\n"
+            "struct LexInput {\n"
+            "const char* buf; size_t tok, pos, lim, stop;\n"
+            "bool more() const { return pos < lim; }\n"
+            "const char* cur() const { return buf + pos; }\n"
+            "bool done() const { return tok >= stop; }\n"
+            "};\n"
+            "struct LexOutput { token_sink* sink; int ok; };\n"
+            "static void putRule(LexOutput& out, const LexInput& in, int rule) {\n"
+            "out.sink->put(out.sink->ctx, rule, in.tok, in.pos - in.tok);\n"
+            "}\n"
+            "static void putError(LexOutput& out, const LexInput& in) { out.ok = 0; putRule(out, in, -1); }\n";
+    genSkipLoops(text);
+    text << "LEX_EXPORT int scan_rule_count() { return " << ruleNames.size() << "; }\n"
+            "LEX_EXPORT int scan_range(const char* data, size_t size, size_t from, size_t stop, token_sink* sink) {\n"
+            "LexInput in = {data, from, from, size, stop};\n"
+            "LexOutput out = {sink, 1};\n"
+            "char ch;\n"
+            "int lastRule = -1; size_t lastLen = 0;\n";
+}
+
+// 共享库的结束部分：scan_range 返回是否出错，scan 扫描整个输入
+void WordAnal::genLibraryEpilogue(QTextStream& text) const {
+    text << "lex_done:\n"
+            "return out.ok;\n}\n"
+            "LEX_EXPORT int scan(const char* data, size_t size, token_sink* sink) {\n"
+            "return scan_range(data, size, 0, size, sink);\n}\n";
+}
+
+/**
+ * @brief 生成保留字的查找函数 int reservedIndex(const char* s, size_t n)
+ * @note 生成时按长度和首字符把保留字分组，生成的函数先 switch 长度，再 switch 首字符，
+ * 最后只和同一组中的几个保留字比较剩下的字符，找到返回它在 ReservedUpper 中的序号，否则返回 -1。
+ * 没有循环，也不构造字符串；ReservedUpper 为生成时就转为大写的保留字，用于输出。
+ * IgnoreCase 时保留字已经在 checkArgs 中转为小写，生成的函数在比较时把单词的大写字母就地转为小写，
+ * 输出的单词文本保持原样（与 writeTokens 一致）。
+*/
+void WordAnal::genReservedLookup(QTextStream& text) const {
+    // 长度 -> 首字符 -> 保留字序号
+    map<int, map<int, vector<size_t>>> groups;
+    vector<QByteArray> words;
+    for(auto & word : ReservedWord){
+        QByteArray bytes = word.toUtf8();
+        if(bytes.isEmpty())
+            continue;
+        groups[bytes.size()][(unsigned char)bytes[0]].push_back(words.size());
+        words.push_back(bytes);
+    }
+    QString lower = IgnoreCase ? "if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';" : "";
+    text << "static const char* const ReservedUpper[" << max<size_t>(words.size(), 1) << "] = {";
+    for(size_t i = 0; i < words.size(); i++)
+        text << (i ? ", " : "") << quoted(QString::fromUtf8(words[i]).toUpper());
+    if(words.empty())
+        text << "\"\"";
+    text << "};\n";
+    if(IgnoreCase)
+        text << "static bool sameWord(const char* s, const char* w, size_t n) {\n"
+                "for (size_t i = 0; i < n; i++) {char c = s[i]; " << lower << " if (c != w[i]) return false;}\n"
+                "return true;\n"
+                "}\n";
+    else
+        text << "static bool sameWord(const char* s, const char* w, size_t n) { return memcmp(s, w, n) == 0; }\n";
+    text << "static int reservedIndex(const char* s, size_t n) {\n";
+    if(!words.empty()){
+        text << "if (n == 0) return -1;\n"
+                "unsigned char c = s[0]; " << lower << "\n"
+                "switch (n) {\n";
+        for(auto & byLength : groups){
+            text << "case " << byLength.first << ":\n"
+                    "switch (c) {\n";
+            for(auto & byFirst : byLength.second){
+                text << "case " << byFirst.first << ":\n";
+                for(auto i : byFirst.second){
+                    const QByteArray& w = words[i];
+                    if(w.size() > 1)
+                        text << "if (sameWord(s + 1, " << quoted(QString::fromUtf8(w.mid(1))) << ", " << (w.size() - 1) << ")) ";
+                    text << "return " << i << ";\n";
+                }
+                text << "break;\n";
+            }
+            text << "}\n"
+                    "break;\n";
+        }
+        text << "}\n";
+    }
+    text << "return -1;\n"
+            "}\n";
+}
+
+/**
+ * @brief 生成 switch 形式的扫描循环
+ * @note 每个 SDFA 状态一个 case，按出边的顺序用 if / else if 比较字符，
+ * 然后依次是终态输出、AnyChar 和没有转移时的处理（genNoMatch）。
+ * 当前字符只有在转移时才读过（in.pos++），终态输出单词后用同一个字符从初态继续。
+ * 输入结束时用一个 switch 按状态处理最后的单词，回退之后还要继续扫描。
+*/
+void WordAnal::genSwitchScanner(QTextStream& text) const {
+    QString startID = QString::number(SDFAgraph.getStart());
+//    函数循环
+    text << "unsigned int state = " + startID + ";\n";
+    text << "while(true){\n";
+//    输入结束时的状态：终态输出最后一个单词，其它状态回退或出错
+    text << "if(!in.more()){\n"
+            "switch(state){\n"
+            "case " + startID + ": goto lex_done;\n";
+    for(size_t id = 0; id < SDFAgraph.size(); id++)
+        if(SDFAgraph.isEnd(id)){
+            text << "case " << id << ": ";
+            genEmitToken(text, size_t(SDFAgraph.getAccept(id)));
+            text << "goto lex_done;\n";
+        }
+    text << "}\n";
+    text << "if(lastRule >= 0){" << rollBack << " state = " + startID + "; continue;}\n"
+            "putError(out, in); goto lex_done;\n"
+            "}\n";
+    text << "ch = in.buf[in.pos];\n"
+            "switch(state){" << endl;
+    for(size_t id = 0; id < SDFAgraph.size(); id++){
+//  默认不存在状态 既是初态，又是终态。因为这意味着程序没有字符也合法
+        text << "case "<< QString::number(id) << ":\n";
+        bool flgElseIf = false;     // 输出if为true，输出else 为false
+        bool flgAnyChar = false;
+        size_t AnyCharTail = SIZE_MAX;  //稍后标记
+        if(id == SDFAgraph.getStart()){// 初始状态需要跳过空白字符
+            text << "if(ch == ' ' || ch == '\\t' || ch == '\\n') " << skipSpaceCode("continue;") << "\n";
+            flgElseIf = true;
+        }
+        if(!SDFAgraph.getEdges(id).empty()){
+            for(auto & edge:SDFAgraph.getEdges(id)){
+                if(flgElseIf){text << "else "; flgElseIf = false; }
+                QString Value = SymbolTable::instance().value(edge.sym);
+                if(Value == "AnyChar"){ // 暂时缓存，到最后再添加AnyChar的代码
+                    flgAnyChar = true;
+                    AnyCharTail = edge.tail;
+                } else {
+                    if(Value == "[0-9]")
+                        text << "if(ch >= '0' && ch <= '9') {\n";
+                    else if(Value == "[a-zA-Z]")
+                        text << "if(ch >= 'a' && ch <= 'z' || ch >= 'A' && ch <= 'Z') {\n";
+                    else if(Value == "\n")  // 换行符 特殊处理
+                        text << "if(ch == '\\n') {\n";
+                    else if(Value.size() == 1)
+                        text << "if(ch == '"+ Value +"') {\n";
+                    else if(Value.size() == 2 && Value[0]=='\\')
+                        text << "if(ch == '"+ Value[1] +"') {\n";
+                    else{
+                        qWarning()<< "ERROR from genProgram(): The size of edgeValue more Than 2!!!" << Value;
+                        return;
+                    }
+                    text << " in.pos++; state = " + QString::number(edge.tail) + ";";
+                    genEnterState(text, edge.tail);
+                    text << "}\n";
+
+                    flgElseIf = true;
+                }
+            }
+        }
+        // 添加AnyChar的代码，终态在没有显式转移时输出单词，不再需要 AnyChar
+        if(flgAnyChar && !SDFAgraph.isEnd(id)){
+            if(flgElseIf){ text << "else "; flgElseIf = false;}
+            text << "{ in.pos++; state = " + QString::number(AnyCharTail) + ";";
+            genEnterState(text, AnyCharTail);
+            text << "}\n";
+        }
+        // 如果最后有 if 或者 else if ，而不是 else，说明可能没有可走的转移
+        else {
+            if(flgElseIf) text << "else ";
+            text << "{";
+            genNoMatch(text, id, "state = " + startID + "; continue;");
+            text << "}\n";
+        }
+        text << "break;" << endl;
+    }
+    text << "}\n}\n";
+}
+
+/**
+ * @brief 生成表格驱动的扫描循环
+ * @note 转移表按 [状态][等价类] 组织，等价类即 createCharClass 得到的 charClass：
+ *      - cls[256]：字节 -> 等价类
+ *      - base / nxt / chk：用行移位（comb）法压缩的转移表。状态 s 在等价类 c 上的转移存放在
+ *        nxt[base[s] + c]，当且仅当 chk[base[s] + c] == s 时有效。
+ *      - anyNext[s]：AnyChar 出边的下一状态，没有为 -1
+ *      - kind[s]：终态的规则序号，非终态为 -1
+ * 每个等价类取出边中第一条覆盖它的边，与 switch 形式中 if / else if 的顺序一致，
+ * 之后依次是终态输出、AnyChar、回退和出错处理，因此各种形式的程序输出完全相同。
+ * 压缩时按行中有效转移的个数从多到少，为每行找到第一个不冲突的位置（first-fit）。
+*/
+void WordAnal::genTableScanner(QTextStream& text) const {
+    genTransitionTables(text);
+    // 进入有自环的状态之后调用它的跳过函数
+    QString skipCases;
+    for(size_t id = 0; id < SDFAgraph.size(); id++)
+        if(isSkipState(id))
+            skipCases += QString("case %1: do in.pos += skip%1(in.cur(), in.lim - in.pos); while (in.pos == in.lim && in.more()); break;\n").arg(id);
+    if(!skipCases.isEmpty())
+        skipCases = "switch(state){\n" + skipCases + "}\n";
+
+//    函数循环
+    QString startID = QString::number(SDFAgraph.getStart());
+    text << "int state = " + startID + ";\n"
+            "while(true){\n"
+            "bool eof = !in.more();\n"
+            "if(eof && state == " + startID + ") break;\n"
+            "if(!eof){\n"
+            "ch = in.buf[in.pos];\n"
+            "if(state == " + startID + " && (ch == ' ' || ch == '\\t' || ch == '\\n')) " + skipSpaceCode("continue;") + "\n"
+            "int idx = base[state] + cls[(unsigned char)ch];\n"
+            "int t = chk[idx] == state ? nxt[idx] : anyNext[state];\n"
+            "if(t >= 0){\n"
+            "in.pos++; state = t;\n" + skipCases +
+            "if(kind[state] >= 0){lastRule = kind[state]; lastLen = in.pos - in.tok;}\n"
+            "continue;}\n"
+            "}\n"
+            "if(kind[state] >= 0){putRule(out, in, kind[state]); in.tok = in.pos; lastRule = -1; " + stopCheck + " state = " + startID + "; continue;}\n"
+            "if(lastRule >= 0){" << rollBack << " state = " + startID + "; continue;}\n"
+            "putError(out, in); goto lex_done;\n"
+            "}\n";
+}
+
+/**
+ * @brief 生成表格形式扫描程序使用的转移表 cls、base、nxt、chk、anyNext、kind
+ * @note 表格都是 static const 数组，也供 genScannerHeader 生成的头文件使用。
+*/
+void WordAnal::genTransitionTables(QTextStream& text) const {
+    const size_t stateCount = SDFAgraph.size();
+    const size_t K = classCount;
+    const int32_t NONE = -1;
+
+    // 未压缩的转移表，以及每个状态的 AnyChar 出边和规则序号
+    vector<vector<int32_t>> dense;
+    vector<int32_t> anyNext, kind(stateCount, NONE);
+    buildTransitionRows(SDFAgraph, dense, anyNext);
+    for(size_t id = 0; id < stateCount; id++)
+        kind[id] = SDFAgraph.getAccept(id);
+
+    // 行移位压缩：有效转移多的行先放
+    vector<size_t> order(stateCount);
+    vector<size_t> rowSize(stateCount, 0);
+    for(size_t id = 0; id < stateCount; id++){
+        order[id] = id;
+        for(size_t c = 0; c < K; c++)
+            if(dense[id][c] != NONE)
+                rowSize[id]++;
+    }
+    stable_sort(order.begin(), order.end(),
+                [&rowSize](size_t a, size_t b){ return rowSize[a] > rowSize[b]; });
+    vector<int32_t> base(stateCount, 0), nxt, chk;
+    size_t entryCount = 0;
+    for(auto id : order){
+        if(rowSize[id] == 0)
+            continue;
+        size_t b = 0;
+        for(;; b++){
+            bool fit = true;
+            for(size_t c = 0; c < K && fit; c++)
+                if(dense[id][c] != NONE && b + c < chk.size() && chk[b + c] != NONE)
+                    fit = false;
+            if(fit)
+                break;
+        }
+        if(chk.size() < b + K){
+            chk.resize(b + K, NONE);
+            nxt.resize(b + K, NONE);
+        }
+        base[id] = int32_t(b);
+        for(size_t c = 0; c < K; c++)
+            if(dense[id][c] != NONE){
+                chk[b + c] = int32_t(id);
+                nxt[b + c] = dense[id][c];
+                entryCount++;
+            }
+    }
+    // 保证任意 base[s] + c 都不越界
+    if(chk.size() < K){
+        chk.resize(K, NONE);
+        nxt.resize(K, NONE);
+    }
+
+    // 所有表中的值都不超过 short 的范围时用 short，否则用 int
+    int32_t maxValue = int32_t(max(stateCount, chk.size()));
+    QString type = maxValue <= 32767 ? "short" : "int";
+    size_t typeBytes = maxValue <= 32767 ? 2 : 4;
+    size_t denseBytes = stateCount * K * typeBytes;
+    size_t combBytes = (2 * chk.size() + stateCount) * typeBytes;
+
+    auto writeArray = [&text](const QString& type, const QString& name, const vector<int32_t>& values){
+        text << "static const " << type << " " << name << "[" << max<size_t>(values.size(), 1) << "] = {";
+        for(size_t i = 0; i < values.size(); i++){
+            if(i) text << (i % 32 ? "," : ",\n");
+            text << values[i];
+        }
+        if(values.empty()) text << "0";
+        text << "};\n";
+    };
+
+    text << "// table scanner: " << stateCount << " states, " << K << " char classes, "
+         << entryCount << " transitions\n"
+            "// dense table " << denseBytes << " bytes, comb-compressed " << combBytes << " bytes\n";
+    vector<int32_t> cls(charClass.begin(), charClass.end());
+    writeArray("unsigned char", "cls", cls);
+    writeArray(type, "base", base);
+    writeArray(type, "nxt", nxt);
+    writeArray(type, "chk", chk);
+    writeArray(type, "anyNext", anyNext);
+    writeArray(type, "kind", kind);
+}
+
+/**
+ * @brief 规则在输出中的名字
+ * @param rule 规则序号
+ * @return 去掉转义符 \ 的变量名，如特殊符号 \* 输出为 *
+ * @note 生成的 switch 程序把变量名直接写在字符串字面量中，转义符会被编译器去掉，这里保持一致
+*/
+QString WordAnal::tokenName(size_t rule) const {
+    const QString& varName = ruleNames[rule];
+    QString name;
+    for(int i = 0; i < varName.size(); i++)
+        if(varName[i] != '\\' || ++i < varName.size())
+            name += varName[i];
+    return name;
+}
+
+/**
+ * @brief 计算每个状态按等价类的转移，供表格和直接编码两种形式以及 SDFAMatcher 使用
+ * @param graph 确定的自动机（SDFA 或 DFA）
+ * @param [out] dense dense[s][c] 为状态 s 在等价类 c 上转移到的下一状态，没有为 -1
+ * @param [out] anyNext 每个状态 AnyChar 出边的下一状态，没有或为终态时为 -1
+ * @note 每个等价类取出边中第一条覆盖它的边，与 switch 形式中 if / else if 的顺序一致。
+ * 终态在没有显式出边时输出单词，不会走 AnyChar 出边。
+*/
+void WordAnal::buildTransitionRows(const Automaton& graph, vector<vector<int32_t>>& dense, vector<int32_t>& anyNext) const {
+    SymbolTable& table = SymbolTable::instance();
+    dense.assign(graph.size(), vector<int32_t>(classCount, -1));
+    anyNext.assign(graph.size(), -1);
+    for(size_t id = 0; id < graph.size(); id++){
+        for(auto & edge : graph.getEdges(id)){
+            const QString& Value = table.value(edge.sym);
+            if(Value == "AnyChar"){
+                if(anyNext[id] < 0 && !graph.isEnd(id))
+                    anyNext[id] = int32_t(edge.tail);
+                continue;
+            }
+            for(auto c : symClasses[edge.sym])
+                if(dense[id][c] < 0)
+                    dense[id][c] = int32_t(edge.tail);
+        }
+    }
+}
+
+/**
+ * @brief 生成输出一个单词的代码
+ * @param rule 单词的规则序号
+ * @note 单词都交给 putRule：可执行程序在那里按 tokFlag 跳过注释、查保留字表并写出文本，
+ * 共享库在那里把规则序号和单词的位置交给调用者。单词的文本为输入缓冲区中的 [in.tok, in.pos)。
+ * 共享库的注释也要交给调用者，分块并行扫描时（scanTokensParallel）相邻的单词之间只能是空白字符。
+*/
+void WordAnal::genEmitToken(QTextStream& text, size_t rule) const {
+    text << "putRule(out, in, " << rule << ");\n";
+}
+
+/**
+ * @brief 生成状态 id 没有可走的转移（或输入结束）时的代码
+ * @param id SDFA 状态
+ * @param restart 回到初态继续扫描的代码
+ * @note 终态输出当前单词；否则如果经过了终态，退回到最后经过的终态输出那个单词（最长匹配）；
+ * 都不是则输出出错单词并结束。输出之后从当前位置开始下一个单词。
+*/
+void WordAnal::genNoMatch(QTextStream& text, size_t id, const QString& restart) const {
+    if(SDFAgraph.isEnd(id)){
+        genEmitToken(text, size_t(SDFAgraph.getAccept(id)));
+        text << "in.tok = in.pos; lastRule = -1; " << stopCheck << " " << restart << "\n";
+        return;
+    }
+    if(id != SDFAgraph.getStart())  // 初态时单词还没有开始，不会经过终态
+        text << "if(lastRule >= 0){" << rollBack << " " << restart << "}\n";
+    text << "putError(out, in); goto lex_done;\n";
+}
+
+/**
+ * @brief 判断状态是否有到自身的转移
+ * @note 这样的状态（标识符的后续字符、注释体的 AnyChar* 等）在生成的程序中有一个跳过函数 skip<id>，
+ * 进入状态之后一次跳过所有留在本状态的字节，不再逐个字节地转移。
+*/
+bool WordAnal::isSkipState(size_t id) const {
+    for(auto & edge : SDFAgraph.getEdges(id))
+        if(edge.tail == id)
+            return true;
+    return false;
+}
+
+/**
+ * @brief 生成跳过函数 size_t skip<id>(const char* p, size_t n) 和跳过空白的 skipSpace
+ * @note 跳过函数返回 [p, p + n) 开头有多少个字节留在本状态（初态的空白字符），
+ * 留在本状态的字节由 buildTransitionRows 的结果得到，与逐个字节转移完全相同：
+ *      - 离开本状态的字节只有一个时（如注释的结束符的第一个字符），直接用 memchr 查找
+ *      - 否则把留下或离开的字节集合（取区间较少的一个）写成不超过 4 个区间，
+ *        GCC / Clang 下有 AVX2 时每次比较 32 个字节，有 SSE2 时每次 16 个，
+ *        区间 [lo, hi] 用一次加法和一次有符号比较判断；
+ *      - 剩下的字节和没有 SIMD 的编译器（或定义了 LEX_NO_SIMD）逐个字节查 256 项的表
+*/
+void WordAnal::genSkipLoops(QTextStream& text) const {
+    const size_t maxRanges = 4;
+    vector<vector<int32_t>> dense;
+    vector<int32_t> anyNext;
+    buildTransitionRows(SDFAgraph, dense, anyNext);
+
+    // 一个字节集合的区间
+    auto toRanges = [](const vector<char>& in){
+        vector<pair<int, int>> ranges;
+        for(int ch = 0; ch < 256; ch++)
+            if(in[ch]){
+                if(!ranges.empty() && ranges.back().second == ch - 1)
+                    ranges.back().second = ch;
+                else
+                    ranges.push_back(make_pair(ch, ch));
+            }
+        return ranges;
+    };
+    // 一组 SIMD 比较，结果的字节为 0xFF 表示属于这些区间；prefix 为 _mm 或 _mm256
+    auto maskExpr = [](const vector<pair<int, int>>& ranges, const QString& prefix){
+        QString expr;
+        for(auto & r : ranges){
+            QString one;
+            if(r.first == r.second)
+                one = QString("%1_cmpeq_epi8(x, %1_set1_epi8(%2))").arg(prefix).arg(int(int8_t(r.first)));
+            else    // x - lo + 128 按有符号数比较
+                one = QString("%1_cmpgt_epi8(%1_set1_epi8(%2), %1_add_epi8(x, %1_set1_epi8(%3)))")
+                        .arg(prefix).arg(r.second - r.first - 127).arg(int(int8_t(128 - r.first)));
+            expr = expr.isEmpty() ? one : QString("%1_or_si%2(%3, %4)").arg(prefix).arg(prefix == "_mm" ? 128 : 256).arg(expr).arg(one);
+        }
+        return expr;
+    };
+    auto genSkip = [&](const QString& name, const vector<char>& stay){
+        vector<char> leave(256);
+        for(int ch = 0; ch < 256; ch++)
+            leave[ch] = !stay[ch];
+        vector<pair<int, int>> stayRanges = toRanges(stay), leaveRanges = toRanges(leave);
+        text << "static size_t " << name << "(const char* p, size_t n) {\n";
+        if(leaveRanges.empty()){
+            text << "(void)p; return n;\n}\n";
+            return;
+        }
+        if(leaveRanges.size() == 1 && leaveRanges[0].first == leaveRanges[0].second){
+            text << "const void* q = memchr(p, " << leaveRanges[0].first << ", n);\n"
+                    "return q ? size_t(static_cast<const char*>(q) - p) : n;\n}\n";
+            return;
+        }
+        text << "static const unsigned char stay[256] = {";
+        for(int ch = 0; ch < 256; ch++)
+            text << (ch ? (ch % 32 ? "," : ",\n") : "") << (stay[ch] ? 1 : 0);
+        text << "};\n"
+                "size_t i = 0;\n";
+        bool useStay = stayRanges.size() < leaveRanges.size();
+        const vector<pair<int, int>>& ranges = useStay ? stayRanges : leaveRanges;
+        if(!ranges.empty() && ranges.size() <= maxRanges){
+            text << "#ifdef LEX_SIMD\n"
+                    "#ifdef __AVX2__\n"
+                    "for (; i + 32 <= n; i += 32) {\n"
+                    "__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));\n"
+                    "unsigned bits = " << (useStay ? "~" : "") << "unsigned(_mm256_movemask_epi8(" << maskExpr(ranges, "_mm256") << "));\n"
+                    "if (bits) return i + __builtin_ctz(bits);\n"
+                    "}\n"
+                    "#endif\n"
+                    "for (; i + 16 <= n; i += 16) {\n"
+                    "__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));\n"
+                    "unsigned bits = " << (useStay ? "~" : "") << "unsigned(_mm_movemask_epi8(" << maskExpr(ranges, "_mm") << "))"
+                 << (useStay ? " & 0xFFFFu" : "") << ";\n"
+                    "if (bits) return i + __builtin_ctz(bits);\n"
+                    "}\n"
+                    "#endif\n";
+        }
+        text << "while (i < n && stay[static_cast<unsigned char>(p[i])]) i++;\n"
+                "return i;\n}\n";
+    };
+
+    vector<char> space(256, 0);
+    space[' '] = space['\t'] = space['\n'] = 1;
+    genSkip("skipSpace", space);
+    for(size_t id = 0; id < SDFAgraph.size(); id++){
+        if(!isSkipState(id))
+            continue;
+        vector<char> stay(256, 0);
+        for(int ch = 0; ch < 256; ch++){
+            int32_t next = dense[id][charClass[ch]];
+            stay[ch] = (next >= 0 ? next : anyNext[id]) == int32_t(id);
+        }
+        genSkip("skip" + QString::number(id), stay);
+    }
+}
+
+/**
+ * @brief 生成统计换行符的函数 size_t countLines(const char* s, size_t n, size_t& after)
+ * @note 与 LexRuntime.h 中的 lexCountLines 相同：返回 [s, s + n) 中换行符的个数，有换行符时 after 为最后一个之后的下标。
+ * 有 SIMD 时每次比较 16 个字节，用 popcount 统计掩码中 1 的个数。扫描时不看换行符，
+ * 只在输出单词（或者移出缓冲区）时对上次统计的位置到单词起点之间的一段统计一次。
+*/
+void WordAnal::genLineCounter(QTextStream& text) const {
+    text << "static size_t countLines(const char* s, size_t n, size_t& after) {\n"
+            "size_t lines = 0, i = 0;\n"
+            "#ifdef LEX_SIMD\n"
+            "const __m128i nl = _mm_set1_epi8('\\n');\n"
+            "for (; i + 16 <= n; i += 16) {\n"
+            "unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)), nl)));\n"
+            "if (mask) { lines += size_t(__builtin_popcount(mask)); after = i + 32 - size_t(__builtin_clz(mask)); }\n"
+            "}\n"
+            "#endif\n"
+            "for (; i < n; i++) if (s[i] == '\\n') { lines++; after = i + 1; }\n"
+            "return lines;\n"
+            "}\n";
+}
+
+// 进入状态 target 之后的代码：有自环的状态先跳过留在本状态的字节（必要时读入下一块），终态再记录最后经过的终态
+void WordAnal::genEnterState(QTextStream& text, size_t target) const {
+    if(isSkipState(target))
+        text << " do in.pos += skip" << target << "(in.cur(), in.lim - in.pos); while (in.pos == in.lim && in.more());";
+    if(SDFAgraph.isEnd(target))
+        text << " lastRule = " << SDFAgraph.getAccept(target) << "; lastLen = in.pos - in.tok;";
+}
+
+// 初态跳过空白字符的代码，restart 为回到初态的代码
+QString WordAnal::skipSpaceCode(const QString& restart) const {
+    return QString("{in.pos++; in.tok = in.pos; do in.pos += skipSpace(in.cur(), in.lim - in.pos); while (in.pos == in.lim && in.more()); "
+                   "in.tok = in.pos; ") + stopCheck + " " + restart + "}";
+}
+
+/**
+ * @brief 生成直接编码（re2c 风格）的扫描程序
+ * @note 每个 SDFA 状态 s 生成一段代码：
+ *      - 标号 S<s>：取当前字符，输入结束时按 genNoMatch 处理最后一个单词
+ *      - 按字节分派到本状态的各个转移 T<s>_<k>：转移的目标相同的字节合并为一组，
+ *        GCC / Clang 下转移组较多的状态用 computed goto 的 256 项跳转表，其它编译器或转移组较少时用 switch，
+ *        字节最多的一组作为 switch 的 default
+ *      - 转移 T<s>_<k>：in.pos++，目标是终态时记录最后经过的终态，goto 到下一状态的 S 标号
+ *      - F<s>：没有显式转移时，终态输出单词并直接跳到初态的分派代码 D<start>，用当前字符继续；
+ *        非终态走 AnyChar 出边，都没有则回退到最后经过的终态，或者输出出错单词并结束
+ * 除了没有状态变量和循环以外，与 switch 形式的行为完全相同。
+ * 先对所有状态分组并记下哪些标号会被 goto，只生成用到的 S、D 标号和 F 代码，避免 -Wunused-label 警告。
+*/
+void WordAnal::genDirectScanner(QTextStream& text) const {
+    const size_t stateCount = SDFAgraph.size();
+    const size_t jumpTableMin = 4;  // 转移组不少于这个数时使用跳转表
+    const size_t start = SDFAgraph.getStart();
+    vector<vector<int32_t>> dense;
+    vector<int32_t> anyNext;
+    buildTransitionRows(SDFAgraph, dense, anyNext);
+
+    text << "#if defined(__GNUC__) && !defined(LEX_NO_COMPUTED_GOTO)\n"
+            "#define LEX_COMPUTED_GOTO 1\n"
+            "#endif\n";
+    // 按转移的值把每个状态的 256 个字节分组，组号按第一次出现的顺序
+    vector<vector<int32_t>> groups(stateCount);
+    vector<vector<int>> byteGroups(stateCount, vector<int>(256, -1));
+    vector<char> hasFail(stateCount, 0);    // 有没有字节走到 F<s>
+    for(size_t id = 0; id < stateCount; id++){
+        for(int ch = 0; ch < 256; ch++){
+            int32_t value = dense[id][charClass[ch]];
+            if(value < 0 || (id == start && (ch == ' ' || ch == '\t' || ch == '\n'))){
+                hasFail[id] = 1;
+                continue;
+            }
+            auto it = find(groups[id].begin(), groups[id].end(), value);
+            byteGroups[id][ch] = int(it - groups[id].begin());
+            if(it == groups[id].end())
+                groups[id].push_back(value);
+        }
+    }
+    // 记下各个状态的代码中 goto 到的 S 标号和 D 标号
+    vector<char> jumped(stateCount, 0);     // S<s> 是否是跳转的目标
+    bool jumpedDispatch = false;            // D<start> 是否是跳转的目标
+    jumped[start] = 1;
+    for(size_t id = 0; id < stateCount; id++){
+        for(int32_t target : groups[id])
+            jumped[size_t(target)] = 1;
+        if(hasFail[id] && anyNext[id] >= 0)
+            jumped[size_t(anyNext[id])] = 1;
+        else if(hasFail[id] && SDFAgraph.isEnd(id))
+            jumpedDispatch = true;
+    }
+
+    text << "goto S" << start << ";\n";
+    for(size_t id = 0; id < stateCount; id++){
+        QString sid = QString::number(id);
+        const vector<int32_t>& groupValue = groups[id];
+        const vector<int>& byteGroup = byteGroups[id];
+
+        if(jumped[id])      // 没有跳转到的状态不生成标号，代码不会执行
+            text << "S" << sid << ":";
+        text << " if(!in.more()){";
+        if(id == start)
+            text << "goto lex_done;";
+        else
+            genNoMatch(text, id, "goto S" + QString::number(start) + ";");
+        text << "}\n"
+                "ch = in.buf[in.pos];\n";
+        if(id == start)
+            text << (jumpedDispatch ? "D" + sid + ":" : QString()) << " if(ch == ' ' || ch == '\\t' || ch == '\\n') " << skipSpaceCode("goto S" + sid + ";") << "\n";
+        if(groupValue.size() >= jumpTableMin){
+            text << "#ifdef LEX_COMPUTED_GOTO\n"
+                    "{static void* const jt[256] = {";
+            for(int ch = 0; ch < 256; ch++){
+                if(ch) text << (ch % 16 ? "," : ",\n");
+                if(byteGroup[ch] < 0)
+                    text << "&&F" << sid;
+                else
+                    text << "&&T" << sid << "_" << byteGroup[ch];
+            }
+            text << "};\n goto *jt[(unsigned char)ch];}\n"
+                    "#else\n";
+        }
+        if(!groupValue.empty()){
+            // 字节最多的一组（包括没有转移的 F）作为 default，其余逐个列出 case
+            vector<int> groupBytes(groupValue.size() + 1, 0);  // 最后一项为 F
+            for(int ch = 0; ch < 256; ch++)
+                groupBytes[byteGroup[ch] < 0 ? groupValue.size() : size_t(byteGroup[ch])]++;
+            size_t defaultGroup = size_t(max_element(groupBytes.begin(), groupBytes.end()) - groupBytes.begin());
+            auto target = [&sid, &groupValue](size_t g){
+                return g == groupValue.size() ? "F" + sid : "T" + sid + "_" + QString::number(g);
+            };
+            text << "switch((unsigned char)ch){\n";
+            for(size_t g = 0; g <= groupValue.size(); g++){
+                if(g == defaultGroup || groupBytes[g] == 0)
+                    continue;
+                int n = 0;
+                for(int ch = 0; ch < 256; ch++)
+                    if(byteGroup[ch] == (g == groupValue.size() ? -1 : int(g)))
+                        text << "case " << ch << (++n % 16 ? ": " : ":\n");
+                text << "goto " << target(g) << ";\n";
+            }
+            text << "default: goto " << target(defaultGroup) << ";}\n";
+        }
+        else
+            text << "goto F" << sid << ";\n";
+        if(groupValue.size() >= jumpTableMin)
+            text << "#endif\n";
+        for(size_t g = 0; g < groupValue.size(); g++){
+            text << "T" << sid << "_" << g << ": in.pos++;";
+            genEnterState(text, size_t(groupValue[g]));
+            text << " goto S" << groupValue[g] << ";\n";
+        }
+        if(!hasFail[id])    // 所有字节都有显式转移，F 不会被用到
+            continue;
+        text << "F" << sid << ":\n";
+        if(anyNext[id] >= 0){
+            text << "in.pos++;";
+            genEnterState(text, size_t(anyNext[id]));
+            text << " goto S" << anyNext[id] << ";\n";
+        }
+        else    // 终态输出后当前字符已经取出，直接跳到初态的分派代码
+            genNoMatch(text, id, "goto " + QString(SDFAgraph.isEnd(id) ? "D" : "S") + QString::number(start) + ";");
+    }
+}
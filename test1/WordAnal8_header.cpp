@@ -0,0 +1,159 @@
+#include "WordAnal.h"
+
+// 名字只由字母、数字和下划线组成并且不以数字开头时可以直接作为枚举名的一部分
+static bool isIdentifier(const QString& name) {
+    if(name.isEmpty())
+        return false;
+    for(int i = 0; i < name.size(); i++){
+        ushort ch = name.at(i).unicode();
+        bool letter = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+        if(!letter && !(i > 0 && ch >= '0' && ch <= '9'))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 生成只有头文件、可重入的词法分析器
+ * @param [in, out] text 输出的代码流
+ * @note 生成的头文件可以直接包含到其它程序中，所有内容都在命名空间 lex 里：
+ *      - enum TokenKind：TOK_EOF（-2）、TOK_ERROR（-1），每条规则一个 TOK_<变量名>（按规则序号），
+ *        每个保留字一个 KW_<大写保留字>；名字不能作为标识符时用序号代替，如 TOK_3
+ *      - struct Token：种别、文本在输入中的位置 [offset, offset + length)、指向文本的指针、行号和列号（从 1 开始，列按字节计）
+ *      - struct Scanner：init(buf, len) 设置输入，next_token() 每次返回一个单词，
+ *        输入结束返回 TOK_EOF，出错时返回 TOK_ERROR 之后只返回 TOK_EOF
+ *      - kind_name(kind)：种别在生成程序输出中的名字
+ * 转移表与表格形式的程序相同（genTransitionTables），都是只读的；
+ * 扫描状态全部在 Scanner 对象中，不分配内存，多个 Scanner 可以在不同线程中同时使用。
+ * 扫描规则与生成的程序和 scanTokens 相同，注释不返回；
+ * 行号和列号在返回单词时才计算，只统计上一个单词到这个单词之间的换行符（genLineCounter）。
+ * 有自环的状态和初态的空白字符与生成的程序一样用跳过函数（genSkipLoops）成块跳过。
+*/
+void WordAnal::genScannerHeader(QTextStream& text) const {
+    if(SDFAgraph.empty())
+        return;
+    text << "#ifndef LEX_SCANNER_H\n"
+            "#define LEX_SCANNER_H\n"
+            "#include <cstddef>\n"
+            "#include <cstring>\n";
+    text << simdInclude;
+    text << "namespace lex {\n";
+
+    // 种别的枚举：先是各条规则，再是保留字
+    set<QString> used;
+    auto enumName = [&used](const QString& prefix, const QString& name, size_t index){
+        QString res = prefix + (isIdentifier(name) ? name : QString::number(index));
+        if(!used.insert(res).second){
+            res = prefix + QString::number(index);
+            used.insert(res);
+        }
+        return res;
+    };
+    QStringList names, flags;
+    text << "enum TokenKind {\n"
+            "TOK_EOF = -2,\n"
+            "TOK_ERROR = -1,\n";
+    for(size_t rule = 0; rule < ruleNames.size(); rule++){
+        QString name = tokenName(rule);
+        text << enumName("TOK_", name, rule) << " = " << rule << ",\n";
+        names << name;
+        const QString& varName = ruleNames[rule];
+        if(varName == "BlockComment" || varName == "LineComment")
+            flags << "1";
+        else if(varName == varReservedWord)
+            flags << "2";
+        else
+            flags << "0";
+    }
+    size_t reservedCount = 0;
+    for(auto & word : ReservedWord){   // 与 genReservedLookup 中 ReservedUpper 的顺序相同
+        if(word.isEmpty())
+            continue;
+        QString upper = word.toUpper();
+        text << enumName("KW_", upper, reservedCount) << " = " << (ruleNames.size() + reservedCount) << ",\n";
+        names << upper;
+        reservedCount++;
+    }
+    text << "};\n";
+
+    text << "struct Token {\n"
+            "int kind;\n"
+            "size_t offset, length;\n"
+            "const char* text;\n"
+            "unsigned line, column;\n"
+            "};\n";
+
+    genTransitionTables(text);
+    genReservedLookup(text);
+    genSkipLoops(text);
+    genLineCounter(text);
+    text << "static const unsigned char tokFlag[" << max(flags.size(), 1) << "] = {"
+         << (flags.empty() ? "0" : flags.join(",")) << "};\n";
+    text << "static const char* const kindNames[" << max(names.size(), 1) << "] = {";
+    for(int i = 0; i < names.size(); i++){
+        QString name = names[i];
+        text << (i ? ", " : "") << "\"" << name.replace("\\", "\\\\").replace("\"", "\\\"") << "\"";
+    }
+    if(names.empty())
+        text << "\"\"";
+    text << "};\n"
+            "inline const char* kind_name(int kind) {\n"
+            "if (kind == TOK_EOF) return \"EOF\";\n"
+            "if (kind == TOK_ERROR) return \"ErrorState\";\n"
+            "return kind >= 0 && kind < " << names.size() << " ? kindNames[kind] : \"\";\n"
+            "}\n";
+
+    QString startID = QString::number(SDFAgraph.getStart());
+    text << "struct Scanner {\n"
+            "const char* buf; size_t len, pos;\n"
+            "size_t counted, lineStart; unsigned line;\n"
+            "bool done;\n"
+            "Scanner() { init(\"\", 0); }\n"
+            "void init(const char* b, size_t n) { buf = b; len = n; pos = 0; counted = 0; lineStart = 0; line = 1; done = false; }\n";
+    // 统计上次统计的位置到单词起点之间的换行符
+    text << "Token make(int kind, size_t begin, size_t end) {\n"
+            "size_t after = 0, n = countLines(buf + counted, begin - counted, after);\n"
+            "if (n) { line += unsigned(n); lineStart = counted + after; }\n"
+            "counted = begin;\n"
+            "Token t = {kind, begin, end - begin, buf + begin, line, unsigned(begin - lineStart + 1)};\n"
+            "return t;\n"
+            "}\n";
+    text << "Token next_token() {\n"
+            "while (!done) {\n"
+            "int state = " << startID << ", lastRule = -1;\n"
+            "size_t tok = pos, lastEnd = 0;\n"
+            "while (true) {\n"
+            "int t = -1;\n"
+            "if (pos < len) {\n"
+            "unsigned char ch = static_cast<unsigned char>(buf[pos]);\n"
+            "if (state == " << startID << " && (ch == ' ' || ch == '\\t' || ch == '\\n')) { pos++; pos += skipSpace(buf + pos, len - pos); tok = pos; continue; }\n"
+            "int idx = base[state] + cls[ch];\n"
+            "t = chk[idx] == state ? nxt[idx] : anyNext[state];\n"
+            "} else if (state == " << startID << ") { done = true; break; }\n"
+            "if (t < 0) break;\n"
+            "pos++; state = t;\n";
+    QString skipCases;
+    for(size_t id = 0; id < SDFAgraph.size(); id++)
+        if(isSkipState(id))
+            skipCases += QString("case %1: pos += skip%1(buf + pos, len - pos); break;\n").arg(id);
+    if(!skipCases.isEmpty())
+        text << "switch (state) {\n" << skipCases << "}\n";
+    text << "if (kind[state] >= 0) { lastRule = kind[state]; lastEnd = pos; }\n"
+            "}\n"
+            "if (done) break;\n"
+            "int rule = kind[state];\n"
+            "if (rule < 0 && lastRule >= 0) { rule = lastRule; pos = lastEnd; }\n"
+            "if (rule < 0) { done = true; return make(TOK_ERROR, tok, pos); }\n"
+            "if (tokFlag[rule] == 1) continue;\n"
+            "if (tokFlag[rule] == 2) {\n"
+            "int r = reservedIndex(buf + tok, pos - tok);\n"
+            "if (r >= 0) return make(" << ruleNames.size() << " + r, tok, pos);\n"
+            "}\n"
+            "return make(rule, tok, pos);\n"
+            "}\n"
+            "return make(TOK_EOF, pos, pos);\n"
+            "}\n"
+            "};\n";
+    text << "}  // namespace lex\n"
+            "#endif  // LEX_SCANNER_H\n";
+}
@@ -0,0 +1,199 @@
+#include "WordAnal.h"
+
+/**
+ * @brief 生成 main 的开始：读入 -b、-B、-l 选项，只有输入文件和输出文件两个参数时扫描这个文件并返回
+ * @param [in, out] text 输出的代码流
+ */
+void WordAnal::genMainStart(QTextStream& text) const {
+    text << "int main(int argc, char** argv) {\n"
+            "int first = 1;\n"
+            "for (; first < argc; first++) {\n"
+            "if (!strcmp(argv[first], \"-b\") || !strcmp(argv[first], \"-B\")) outFormat = argv[first][1] == 'b' ? 1 : 2;\n"
+            "else if (!strcmp(argv[first], \"-l\")) trackLines = true;\n"
+            "else break;\n"
+            "}\n"
+            "if (argc == first + 2 && argv[first][0] != '-' && argv[first][0] != '@') {\n"
+            "FILE* fin = fopen(argv[first], \"r\");\n"
+                "if(!fin)\n\t{printf(\"Can't Open Infile %s\", argv[first]); return 1;}\n"
+            "FILE* fout = fopen(argv[first + 1], outFormat ? \"wb\" : \"w\");\n"
+                "if(!fout)\n\t{printf(\"Can't Open Outfile %s\", argv[first + 1]); fclose(fin); return 1;}\n"
+            "string out; out.reserve(1 << 20);\n"
+            "uint64_t count = scanFile(fin, out);\n"
+            "if (outFormat && !makeStream(fin, out, count))\n\t{printf(\"Infile %s is too large for -b, use -B\", argv[first]); fclose(fin); fclose(fout); return 1;}\n"
+            "fwrite(out.data(), 1, out.size(), fout);\n"
+            "fclose(fin);\n"
+            "fclose(fout);\n"
+            "return 0;\n"
+            "}\n";
+}
+
+/**
+ * @brief 生成只扫描一个文件的 main：程序 [-b | -B] [-l] 输入文件 输出文件
+ * @param [in, out] text 输出的代码流
+ * @note 只用到标准库，不需要线程和目录遍历，可以在任何平台上编译
+ */
+void WordAnal::genMain(QTextStream& text) const {
+    genMainStart(text);
+    text << "printf(\"Usage: %s [-b|-B] [-l] Infile Outfile\\n\", argv[0]);\n"
+            "return 1;\n"
+            "}\n";
+}
+
+/**
+ * @brief 生成可执行程序的 main：扫描一个文件，或者在线程池中批量扫描多个文件和目录
+ * @param [in, out] text 输出的代码流
+ * @note 生成的程序有两种用法：
+ *      - 程序 [-b | -B] [-l] 输入文件 输出文件：与以前相同，扫描一个文件
+ *      - 程序 [-b | -B] [-l] [-j 线程数] (-o 输出目录 | -m 合并输出文件) 路径...：路径可以是文件、目录（递归，按名字排序）
+ *        或 @列表文件（每行一个路径）。-o 时每个输入文件输出到已存在的输出目录下的一个文件，
+ *        文件名为输入路径中的 / \ : 换成 _ 再加上 .tok（单词流为 .lexb）；-m 时所有输出按输入的顺序合并为一个带索引的文件：
+ *            LEXINDEX 文件数
+ *            起点\t字节数\t输入路径      （每个文件一行，起点从索引之后的第一个字节算起）
+ *            各个文件的输出
+ *        线程数默认为硬件的线程数，结束时在 stderr 输出文件数、失败的文件数、总字节数、用时和 MB/s。
+ *        打不开或者有出错单词的文件算作失败（与 tokenizeFiles 的统计相同），有失败的文件时返回 1。
+ * -b 时每个文件输出为定长记录的二进制单词流，-B 时为变长差分编码的单词流（genStreamOutput），默认为文本。
+ * -l 时文本的每一行在种别名之后加上 "\t行号:列号"；单词流中有源文本，读入时再计算行号，不受 -l 影响。
+ * 规则中有 BatchMain 参数时才生成，目录在 Windows 上用 FindFirstFile 遍历，其它系统用 opendir / readdir。
+ * 线程池中每个线程有自己的任务队列，大的文件先分配，从自己的队首取任务，空了就从其它线程的队尾偷一个。
+ * 转移表、保留字表等都是只读的全局数组，所有线程共用；每个文件有自己的输入缓冲区和输出缓冲区。
+*/
+void WordAnal::genBatchMain(QTextStream& text) const {
+    text << "#include <deque>\n"
+            "#include <chrono>\n"
+            "#include <mutex>\n"
+            "#include <thread>\n"
+            "#if defined(_WIN32)\n"
+            "#define WIN32_LEAN_AND_MEAN\n"
+            "#define NOMINMAX\n"
+            "#include <windows.h>\n"
+            "#else\n"
+            "#include <dirent.h>\n"
+            "#include <sys/stat.h>\n"
+            "#endif\n";
+    text << "struct WorkQueue { mutex m; deque<size_t> jobs; };\n"
+            "template<class Task> static void runPool(size_t count, unsigned threads, Task task) {\n"
+            "vector<WorkQueue> queues(threads);\n"
+            "for (size_t i = 0; i < count; i++) queues[i % threads].jobs.push_back(i);\n"
+            "auto worker = [&](unsigned self) {\n"
+            "for (;;) {\n"
+            "size_t job = 0; bool found = false;\n"
+            "for (unsigned k = 0; k < threads && !found; k++) {\n"
+            "WorkQueue& q = queues[(self + k) % threads];\n"
+            "lock_guard<mutex> lock(q.m);\n"
+            "if (q.jobs.empty()) continue;\n"
+            "if (k == 0) { job = q.jobs.front(); q.jobs.pop_front(); }\n"
+            "else { job = q.jobs.back(); q.jobs.pop_back(); }\n"
+            "found = true;\n"
+            "}\n"
+            "if (!found) return;\n"
+            "task(job);\n"
+            "}\n"
+            "};\n"
+            "vector<thread> pool;\n"
+            "for (unsigned t = 1; t < threads; t++) pool.push_back(thread(worker, t));\n"
+            "worker(0);\n"
+            "for (auto& t : pool) t.join();\n"
+            "}\n";
+    // 输入文件的列表：文件、目录和列表文件；不存在的路径也加入列表，扫描时打不开，算作失败的文件
+    text << "struct InputFile { string path; size_t size; };\n"
+            "static void addPath(const string& path, vector<InputFile>& files) {\n"
+            "vector<string> names;\n"
+            "#if defined(_WIN32)\n"
+            "WIN32_FILE_ATTRIBUTE_DATA st;\n"
+            "if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &st)) { InputFile f = {path, 0}; files.push_back(f); return; }\n"
+            "if (!(st.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {\n"
+            "InputFile f = {path, size_t((uint64_t(st.nFileSizeHigh) << 32) | st.nFileSizeLow)}; files.push_back(f); return;\n"
+            "}\n"
+            "WIN32_FIND_DATAA e;\n"
+            "HANDLE dir = FindFirstFileA((path + \"\\\\*\").c_str(), &e);\n"
+            "if (dir == INVALID_HANDLE_VALUE) { fprintf(stderr, \"Can't Open %s\\n\", path.c_str()); return; }\n"
+            "do if (strcmp(e.cFileName, \".\") && strcmp(e.cFileName, \"..\")) names.push_back(e.cFileName); while (FindNextFileA(dir, &e));\n"
+            "FindClose(dir);\n"
+            "#else\n"
+            "struct stat st;\n"
+            "if (stat(path.c_str(), &st) != 0) { InputFile f = {path, 0}; files.push_back(f); return; }\n"
+            "if (!S_ISDIR(st.st_mode)) { InputFile f = {path, size_t(st.st_size)}; files.push_back(f); return; }\n"
+            "DIR* dir = opendir(path.c_str());\n"
+            "if (!dir) { fprintf(stderr, \"Can't Open %s\\n\", path.c_str()); return; }\n"
+            "while (dirent* e = readdir(dir))\n"
+            "if (strcmp(e->d_name, \".\") && strcmp(e->d_name, \"..\")) names.push_back(e->d_name);\n"
+            "closedir(dir);\n"
+            "#endif\n"
+            "sort(names.begin(), names.end());\n"
+            "for (auto& name : names) addPath(path + \"/\" + name, files);\n"
+            "}\n"
+            "static void addList(const char* listPath, vector<InputFile>& files) {\n"
+            "FILE* f = fopen(listPath, \"r\");\n"
+            "if (!f) { fprintf(stderr, \"Can't Open %s\\n\", listPath); return; }\n"
+            "char line[4096];\n"
+            "while (fgets(line, sizeof line, f)) { size_t n = strcspn(line, \"\\r\\n\"); line[n] = 0; if (n) addPath(line, files); }\n"
+            "fclose(f);\n"
+            "}\n"
+            "static string outputName(const string& dir, string path) {\n"
+            "for (auto& c : path) if (c == '/' || c == '\\\\' || c == ':') c = '_';\n"
+            "return dir + \"/\" + path + (outFormat ? \".lexb\" : \".tok\");\n"
+            "}\n";
+    genMainStart(text);
+    text << "unsigned threads = thread::hardware_concurrency();\n"
+            "const char* outDir = 0; const char* merged = 0;\n"
+            "vector<InputFile> files;\n"
+            "for (int i = first; i < argc; i++) {\n"
+            "string arg = argv[i];\n"
+            "if (arg == \"-j\" && i + 1 < argc) threads = unsigned(atoi(argv[++i]));\n"
+            "else if (arg == \"-o\" && i + 1 < argc) outDir = argv[++i];\n"
+            "else if (arg == \"-m\" && i + 1 < argc) merged = argv[++i];\n"
+            "else if (arg == \"-b\" || arg == \"-B\") outFormat = arg[1] == 'b' ? 1 : 2;\n"
+            "else if (arg == \"-l\") trackLines = true;\n"
+            "else if (arg[0] == '@') addList(argv[i] + 1, files);\n"
+            "else addPath(arg, files);\n"
+            "}\n"
+            "if (!outDir == !merged || files.empty()) {\n"
+            "printf(\"Usage: %s [-b|-B] [-l] Infile Outfile\\n\"\n"
+            "\"       %s [-b|-B] [-l] [-j threads] (-o outdir | -m merged) file|dir|@list...\\n\", argv[0], argv[0]);\n"
+            "return 1;\n"
+            "}\n"
+            "if (threads == 0) threads = 1;\n"
+            "if (threads > files.size()) threads = unsigned(files.size());\n"
+            "vector<size_t> order(files.size());\n"
+            "for (size_t i = 0; i < order.size(); i++) order[i] = i;\n"
+            "stable_sort(order.begin(), order.end(), [&files](size_t a, size_t b) { return files[a].size > files[b].size; });\n"
+            "vector<string> outputs(merged ? files.size() : 0);\n"
+            "vector<char> failed(files.size(), 0);\n"
+            "chrono::steady_clock::time_point t0 = chrono::steady_clock::now();\n"
+            "runPool(files.size(), threads, [&](size_t job) {\n"
+            "size_t i = order[job];\n"
+            "FILE* fin = fopen(files[i].path.c_str(), \"r\");\n"
+            "if (!fin) { failed[i] = 1; fprintf(stderr, \"Can't Open Infile %s\\n\", files[i].path.c_str()); return; }\n"
+            "string out; bool error = false;\n"
+            "uint64_t count = scanFile(fin, out, &error);\n"
+            "if (outFormat && !makeStream(fin, out, count)) { error = true; fprintf(stderr, \"Infile %s is too large for -b, use -B\\n\", files[i].path.c_str()); }\n"
+            "fclose(fin);\n"
+            "failed[i] = error;\n"
+            "if (merged) { outputs[i].swap(out); return; }\n"
+            "string name = outputName(outDir, files[i].path);\n"
+            "FILE* fout = fopen(name.c_str(), outFormat ? \"wb\" : \"w\");\n"
+            "if (!fout) { failed[i] = 1; fprintf(stderr, \"Can't Open Outfile %s\\n\", name.c_str()); return; }\n"
+            "fwrite(out.data(), 1, out.size(), fout);\n"
+            "fclose(fout);\n"
+            "});\n"
+            "if (merged) {\n"
+            "FILE* fout = fopen(merged, outFormat ? \"wb\" : \"w\");\n"
+                "if(!fout)\n\t{printf(\"Can't Open Outfile %s\", merged); return 1;}\n"
+            "fprintf(fout, \"LEXINDEX %lu\\n\", (unsigned long)files.size());\n"
+            "unsigned long offset = 0;\n"
+            "for (size_t i = 0; i < files.size(); i++) {\n"
+            "fprintf(fout, \"%lu\\t%lu\\t%s\\n\", offset, (unsigned long)outputs[i].size(), files[i].path.c_str());\n"
+            "offset += (unsigned long)outputs[i].size();\n"
+            "}\n"
+            "for (auto& out : outputs) fwrite(out.data(), 1, out.size(), fout);\n"
+            "fclose(fout);\n"
+            "}\n"
+            "double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();\n"
+            "double bytes = 0; int failures = 0;\n"
+            "for (size_t i = 0; i < files.size(); i++) { bytes += double(files[i].size); failures += failed[i]; }\n"
+            "fprintf(stderr, \"%lu files, %d failed, %.1f MB, %.3f s, %.1f MB/s, %u threads\\n\", (unsigned long)files.size(), failures,\n"
+            "bytes / 1e6, seconds, seconds > 0 ? bytes / 1e6 / seconds : 0.0, threads);\n"
+            "return failures ? 1 : 0;\n"
+            "}\n";
+}
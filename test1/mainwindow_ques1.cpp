@@ -1,387 +1,710 @@
-#include "mainwindow.h"
-#include "ui_mainwindow.h"
-
-void MainWindow::on_btnNfa_clicked() {
-    currState = nfa;
-    resetQues01_TableLayout();
-    vector<NFAState> nfas = mQues01.getNFAstates();
-    if(nfas.size() < 1){
-        QMessageBox::information(this,"解析文本错误","得到的 NFA 数组为空");
-        return;
-    }
-    for(auto & nfa:nfas)
-        mNodes.push_back(&nfa);
-    setTable();// 设置表格数据
-}
-
-void MainWindow::on_btnDfa_clicked() {
-    currState = dfa;
-    resetQues01_TableLayout();
-    vector<DFAState> dfas = mQues01.getDFAstates();
-    if(dfas.empty()){
-        QMessageBox::information(this,"解析文本错误","得到的 DFA 数组为空");
-        return;
-    }
-    for(auto & dfa:dfas)
-        mNodes.push_back(&dfa);
-    setTable();// 设置表格数据
-}
-
-void MainWindow::on_btnSdfa_clicked() {
-    currState = sdfa;
-    resetQues01_TableLayout();
-    vector<SDFAState> sdfas = mQues01.getSDFAstates();
-    if(sdfas.empty()){
-        QMessageBox::information(this,"解析文本错误","得到的 SDFA 数组为空");
-        return;
-    }
-    for(auto & sdfa:sdfas)
-        mNodes.push_back(&sdfa);
-    setTable();// 设置表格数据
-}
-
-void MainWindow::on_btnWordAnal_clicked(){
-    currState = nothing;
-    resetQues01_SrcCodeLayout();
-}
-
-// 重新设置 WordAnal 的表格布局
-void MainWindow::resetQues01_TableLayout() {
-    clearAnswer(ui->gridLayout_WordAnal);
-    // 生成 状态转换
-    mQues01.parseExpressions(ui->inputText->toPlainText(),currState);
-    mTransChars = mQues01.getTransChar();
-    // 新增 label 生成转换图按钮 和 表格视图
-    mTitle = new QLabel(QString("%1状态转换表：初态(绿)/终态(红)/初终态(黄)").arg(getStateStr()));
-    mBtnGraph = new QPushButton(QString("生成%1转换图").arg(getStateStr()));
-    mAnsTable = new QTableWidget();
-    // 设置字体
-    mTitle->setFont(ChineseFont);
-    mBtnGraph->setFont(ChineseFont);
-
-    // 绑定信号和槽函数，展示图片
-    connect(mBtnGraph, SIGNAL(clicked()), this,SLOT(showGraph()));
-
-    // 设置布局
-    ui->gridLayout_WordAnal->addWidget(ui->GroupWord, 0, 0, 1, 7);
-    ui->gridLayout_WordAnal->addWidget(mTitle, 1, 0);
-    ui->gridLayout_WordAnal->addWidget(mBtnGraph, 1, 3, 1, 4);
-    ui->gridLayout_WordAnal->addWidget(mAnsTable, 2, 0, 1, 7);
-
-    // 设置行和列的伸展因子
-    ui->gridLayout_WordAnal->setRowStretch(0, 0);
-    ui->gridLayout_WordAnal->setRowStretch(1, 0);
-    ui->gridLayout_WordAnal->setRowStretch(2, 1);
-}
-
-// 重新设置 WordAnal 的表格布局
-void MainWindow::resetQues01_SrcCodeLayout() {
-    clearAnswer(ui->gridLayout_WordAnal);
-    // 新增标签、文本编辑器和按钮
-    mTitle = new QLabel("源程序");
-    mLabelTestCode = new QLabel("输入测试代码");
-    mLabelEncoding = new QLabel("单词编码输出");
-    mBtnGenProgram = new QPushButton("生成源程序");
-    mBtnRunProgram = new QPushButton("运行源程序");
-    mBtnOpenTestCode = new QPushButton("打开测试代码");
-    mBtnSaveEncoding = new QPushButton("保存单词编码");
-    mProgram = new QTextEdit();
-    mTestCode = new QTextEdit();
-    mEncoding = new QTextEdit();
-    // 设置字体
-    mTitle->setFont(ChineseFont);
-    mLabelTestCode->setFont(ChineseFont);
-    mLabelEncoding->setFont(ChineseFont);
-    mBtnGenProgram->setFont(ChineseFont);
-    mBtnRunProgram->setFont(ChineseFont);
-    mBtnOpenTestCode->setFont(ChineseFont);
-    mBtnSaveEncoding->setFont(ChineseFont);
-    mProgram->setFont(EnglishFont);
-    mTestCode->setFont(EnglishFont);
-    mEncoding->setFont(EnglishFont);
-
-    // 绑定信号和槽函数
-    connect(mBtnGenProgram, SIGNAL(clicked()), this, SLOT(getProgram()));
-    connect(mBtnRunProgram, SIGNAL(clicked()), this, SLOT(runProgram()));
-    connect(mBtnOpenTestCode, SIGNAL(clicked()), this, SLOT(openEncoding()));
-    connect(mBtnSaveEncoding, SIGNAL(clicked()), this, SLOT(saveEncoding()));
-    // 设置按钮不可点击
-    mBtnRunProgram->setEnabled(false);
-    mBtnSaveEncoding->setEnabled(false);
-
-    // 设置布局
-    ui->gridLayout_WordAnal->addWidget(ui->GroupWord, 0, 0, 1, 7);
-
-    ui->gridLayout_WordAnal->addWidget(mTitle, 1, 0);
-    ui->gridLayout_WordAnal->addWidget(mBtnGenProgram, 1, 1);
-    ui->gridLayout_WordAnal->addWidget(mLabelTestCode, 1, 2);
-    ui->gridLayout_WordAnal->addWidget(mBtnOpenTestCode, 1, 3);
-    ui->gridLayout_WordAnal->addWidget(mBtnRunProgram, 1, 4);
-    ui->gridLayout_WordAnal->addWidget(mLabelEncoding, 1, 5);
-    ui->gridLayout_WordAnal->addWidget(mBtnSaveEncoding, 1, 6);
-
-    ui->gridLayout_WordAnal->addWidget(mProgram, 2, 0, 1, 2);
-    ui->gridLayout_WordAnal->addWidget(mTestCode, 2, 2, 1, 3);
-    ui->gridLayout_WordAnal->addWidget(mEncoding, 2, 5, 1, 2);
-
-    // 设置行和列的伸展因子
-    ui->gridLayout_WordAnal->setRowStretch(0, 0);
-    ui->gridLayout_WordAnal->setRowStretch(1, 0);
-    ui->gridLayout_WordAnal->setRowStretch(2, 1);
-
-    ui->gridLayout_WordAnal->setColumnStretch(0, 0);
-    ui->gridLayout_WordAnal->setColumnStretch(1, 1);
-    ui->gridLayout_WordAnal->setColumnStretch(2, 0);
-    ui->gridLayout_WordAnal->setColumnStretch(3, 0);
-    ui->gridLayout_WordAnal->setColumnStretch(4, 0);
-    ui->gridLayout_WordAnal->setColumnStretch(5, 0);
-    ui->gridLayout_WordAnal->setColumnStretch(6, 1);
-}
-
-// 显示 WordAnal 状态转换表 的数据
-void MainWindow::setTable() {
-    QStringList header;
-    // 设置列标签
-    header << "初态/终态"<< "状态编号" << "变量名";
-    for (auto & ch : mTransChars)
-        if(ch[0] == '\\')
-            header << ch.mid(1);
-        else
-            header << ch;
-    mAnsTable->setColumnCount(mTransChars.size() + 3);     // 设定列的数量
-    mAnsTable->setHorizontalHeaderLabels(header);    // 设定列名
-    mAnsTable->verticalHeader()->setVisible(false);  // 隐藏行号
-    mAnsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);  // 单元格内容不可编辑
-
-    //逐行更新item
-    for (auto & tmp : mNodes) {
-        size_t i = tmp->getStateID();
-        mAnsTable->insertRow(mAnsTable->rowCount());
-
-        //第一列 -初态(绿) / +终态(红) / +-初终态(黄)
-        if (tmp->getIsStart() && tmp->getIsEnd()) {
-            mAnsTable->setItem(i, 0, new QTableWidgetItem(QString("+-")));
-            mAnsTable->item(i, 0)->setBackground(
-                QBrush(QColor(255, 255, 0)));  //黄色
-        } else if (tmp->getIsStart()) {
-            mAnsTable->setItem(i, 0, new QTableWidgetItem(QString("-")));
-            mAnsTable->item(i, 0)->setBackground(
-                QBrush(QColor(0, 255, 0)));  //绿色
-        } else if (tmp->getIsEnd()) {
-            mAnsTable->setItem(i, 0, new QTableWidgetItem(QString("+")));
-            mAnsTable->item(i, 0)->setBackground(
-                QBrush(QColor(255, 0, 0)));  //红色
-        }
-
-        // 第二列 node 编号
-        QString itemStr = QString::number(i);
-        mAnsTable->setItem(i, 1, new QTableWidgetItem(itemStr));
-
-        // 第三列 node 内容
-        if(tmp->getVarName()!="")
-            mAnsTable->setItem(i, 2, new QTableWidgetItem(tmp->getVarName()));
-
-        //第四列 及之后
-        int col = 3;
-        for (auto & ch:mTransChars) {
-            set<size_t> res = tmp->getTrans(ch);
-            if (res.size())
-                mAnsTable->setItem(i, col, new QTableWidgetItem(setTOstr(res)));
-            col++;
-        }  // end for
-    }   // end for table cols
-    mAnsTable->resizeColumnsToContents();// 根据内容来确定列宽度
-}
-
-void MainWindow::showGraph() {
-    QDir tmpDir(QDir::currentPath() + "/tmp");
-    if (!tmpDir.exists())
-        tmpDir.mkpath(".");
-
-    // 指定 DOT 暂存文件的路径和名称
-    QString fileName = QDir::currentPath() + "/tmp/" + getStateStr();
-
-    // 将 DOT 代码写入暂存文件中
-    QFile dotFile(fileName + ".dot");
-    if (dotFile.open(QIODevice::WriteOnly)) {
-        dotFile.write(genDotFile());
-        dotFile.close();
-        // 调用 Graphviz 命令生成图像文件
-        QString cmd = QString("dot -Gcharset=utf8 -Tsvg -o \"%1.svg\" \"%2.dot\" ").arg(fileName).arg(fileName);
-        QProcess::execute(cmd);
-        // 打开默认设备，显示生成的图像
-        QDesktopServices::openUrl(QUrl::fromLocalFile(fileName + ".svg"));
-    }
-}
-
-void MainWindow::getProgram() {
-    resetQues01_SrcCodeLayout();
-//    如果规则文本为空，提示输入文本内容
-    if(ui->inputText->toPlainText().isEmpty()){
-        QMessageBox::information(this,"解析文本错误","请输入文本内容");
-        return;
-    }
-    // 生成状态转换
-    mQues01.parseExpressions(ui->inputText->toPlainText(), currState);
-    if(mQues01.getSDFAstates().empty())
-        QMessageBox::information(this,"解析文本错误","得到的 SDFA 数组为空");
-
-    QDir tmpDir(QDir::currentPath() + "/tmp");
-    if (!tmpDir.exists())
-        tmpDir.mkpath(".");
-
-    QFile file(QDir::currentPath() + "/tmp/WordAnal_Program.cpp");
-    QString program;
-//    写入文件
-    if(file.open(QIODevice::WriteOnly | QIODevice::Text)){
-        QTextStream text(&file);
-        mQues01.genProgram(text);// 写入文件
-        file.close();
-    } else
-        QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
-
-//    读取文件
-    if(file.open(QIODevice::ReadOnly | QIODevice::Text)){
-        QTextStream text(&file);
-        program = text.readAll();// 读取文件
-        file.close();
-    } else
-        QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
-    mProgram->setText("");
-    if(program != ""){
-        mProgram->setText(program);
-        mBtnRunProgram->setEnabled(true);
-    }
-    else
-        QMessageBox::information(this,"解析文本错误","得到的 SDFA 数组为空");
-}
-
-void MainWindow::runProgram() {
-    // 准备输入的测试文件
-    QString inFileName = "Word.in";
-    QString outFileName = "Word.out";
-    QString inFilePath = QDir::currentPath() + "/tmp/" + inFileName;
-    QString outFilePath = QDir::currentPath() + "/tmp/" + outFileName;
-    QFile file(inFilePath);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream text(&file);
-        text << mTestCode->toPlainText(); // 写入文件
-        file.close();
-    } else {
-        QMessageBox::information(this, "Failed to Open Input File!", "Failed to open file for writing!");
-        return;
-    }
-
-    // 编译程序
-    QString programPath = QDir::currentPath() + "/tmp/WordAnal_Program.cpp";
-    QString execPath = QDir::currentPath() + "/tmp/WordAnal_Program.exe";
-    QProcess process1;
-    process1.setWorkingDirectory(QDir::currentPath() + "/tmp");
-    process1.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
-    process1.start("g++", QStringList() << "-o" << execPath << programPath);
-    if (!process1.waitForFinished()) {
-        QMessageBox::information(this, "Compile Error!", "Failed to compile the program: " + process1.readAllStandardError());
-        return;
-    }
-
-    // 运行程序
-    QProcess process2;
-    process2.setWorkingDirectory(QDir::currentPath() + "/tmp");
-    process2.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
-    process2.start(execPath, QStringList() << inFilePath << outFilePath);
-    if (!process2.waitForFinished()) {
-        QMessageBox::information(this, "Run Error!", "Failed to run the program: " + process2.errorString());
-        return;
-    }
-
-    // 读入文件并显示文本
-    QFile file2(outFilePath);
-    if (file2.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream text(&file2);
-        mEncoding->setText(text.readAll());
-        file2.close();
-        mBtnSaveEncoding->setEnabled(true);
-    } else {
-        QMessageBox::information(this, "Failed to Open Output File!", "Failed to open file for reading!");
-        return;
-    }
-}
-
-void MainWindow::saveEncoding() {
-   QString fileName = QFileDialog::getSaveFileName(this, "单词编码保存至文件", "../test_data", "");
-   if (!fileName.isEmpty()) {
-       QFile file(fileName);
-       QByteArray text = mEncoding->toPlainText().toUtf8();
-       if (file.open(QIODevice::WriteOnly)) {
-           file.write(text, text.length());
-           file.close();
-           QMessageBox::information(this, "File Saved!", "File has been saved successfully!");
-       } else
-           QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
-   } else
-       QMessageBox::information(this, "Failed to Save File!", "File name is Empty!");
-}
-
-void MainWindow::openEncoding() {
-    QString fileName = QFileDialog::getOpenFileName(this, "打开测试代码文件", "../test_data", "");
-    if (!fileName.isEmpty()) {
-        QFile file(fileName);
-        if(file.open(QIODevice::ReadOnly)){
-            mTestCode->setText(file.readAll());
-            file.close();
-        } else
-            QMessageBox::information(this, "Failed to Read File!", "Maybe the file not exist!");
-    } else
-        QMessageBox::information(this, "Failed to Open File!", "File name is Empty!");
-}
-
-// 由于需要使用UTF8编码，所以返回二进制格式 QByteArray
-QByteArray MainWindow::genDotFile() {
-    QByteArray output;
-    // 文件头部
-    output += "digraph " + getStateStr() + " {\n";
-    output += "\t rankdir=LR;\n ";
-    output += "\t node [fontname=\"Consolas\", shape = ellipse];\n";
-    output += "\t edge [fontname=\"Consolas\"];\n";
-
-    // 添加节点
-    for (int i = 0; i < mAnsTable->rowCount(); i++) {
-        output += QString("\ts%1").arg(i) + " [style=filled, ";
-        QTableWidgetItem *item = mAnsTable->item(i, 0);
-        if(item != nullptr && !item->text().isEmpty()){
-            if (item->text() == "+"){
-                // 终态，红色
-                output += "peripheries=2, color=red, label=\""
-                        + mAnsTable->item(i, 1)->text() + "\\n"
-                        +  mAnsTable->item(i, 2)->text()  + "\"];\n";
-            }
-            else if (item->text() == "-") // 初态，绿色
-                output += "color=green, label=\"" + mAnsTable->item(i, 1)->text() + "\"];\n";
-            else // 初终态，黄色
-                output += "peripheries=2, color=yellow, label=\""
-                        + mAnsTable->item(i, 1)->text() + "\\n"
-                        + mAnsTable->item(i, 2)->text()  + "\"];\n";
-        } else
-            output += "label=\"" + mAnsTable->item(i, 1)->text() + "\"];\n";
-    }
-
-    // 添加边
-    for (int from = 0; from < mAnsTable->rowCount(); from++)
-        for (int to = 3; to < mAnsTable->columnCount(); to++)
-            if (mAnsTable->item(from, to) != nullptr) {
-                QString label = mAnsTable->horizontalHeaderItem(to)->text();
-                QString edgeId = QString("e%1_%2").arg(from).arg(to);
-                QString fromId = QString("s%1").arg(from);
-
-                QString toSet = mAnsTable->item(from, to)->text();
-                toSet = toSet.mid(1,toSet.size()-2);
-                QStringList toList = toSet.split(",");
-                for(auto & toText :toList ){
-                    QString toId = QString("s%1").arg(toText);
-                    output += QString("\t%1 -> %2 [label=\"").arg(fromId).arg(toId);
-                    output += label.toUtf8() + "\"];\n";
-                }
-            }
-    output += "}\n";
-    return output;
-}
+#include "mainwindow.h"
+#include "ui_mainwindow.h"
+
+void MainWindow::on_btnNfa_clicked() {
+    currState = nfa;
+    resetQues01_TableLayout();
+    vector<NFAState> nfas = mQues01.getNFAstates();
+    if(nfas.size() < 1){
+        QMessageBox::information(this,"解析文本错误","得到的 NFA 数组为空");
+        return;
+    }
+    for(auto & nfa:nfas)
+        mNodes.push_back(&nfa);
+    setTable();// 设置表格数据
+}
+
+void MainWindow::on_btnDfa_clicked() {
+    currState = dfa;
+    resetQues01_TableLayout();
+    vector<DFAState> dfas = mQues01.getDFAstates();
+    if(mQues01.isDFAOverflow()){
+        QMessageBox::information(this,"DFA 超出预算","DFA 的状态数或内存超出预算，已改用位并行 NFA 模拟进行词法分析");
+        return;
+    }
+    if(dfas.empty()){
+        QMessageBox::information(this,"解析文本错误","得到的 DFA 数组为空");
+        return;
+    }
+    for(auto & dfa:dfas)
+        mNodes.push_back(&dfa);
+    setTable();// 设置表格数据
+}
+
+void MainWindow::on_btnSdfa_clicked() {
+    currState = sdfa;
+    resetQues01_TableLayout();
+    vector<SDFAState> sdfas = mQues01.getSDFAstates();
+    if(mQues01.isDFAOverflow()){
+        QMessageBox::information(this,"DFA 超出预算","DFA 的状态数或内存超出预算，已改用位并行 NFA 模拟进行词法分析");
+        return;
+    }
+    if(sdfas.empty()){
+        QMessageBox::information(this,"解析文本错误","得到的 SDFA 数组为空");
+        return;
+    }
+    for(auto & sdfa:sdfas)
+        mNodes.push_back(&sdfa);
+    setTable();// 设置表格数据
+}
+
+void MainWindow::on_btnDirectDfa_clicked() {
+    currState = directDfa;
+    resetQues01_TableLayout();
+    vector<DFAState> dfas = mQues01.getDFAstates();
+    if(dfas.empty()){
+        QMessageBox::information(this,"解析文本错误","得到的 DFA 数组为空");
+        return;
+    }
+    for(auto & dfa:dfas)
+        mNodes.push_back(&dfa);
+    setTable();// 设置表格数据
+}
+
+// 按需构造 DFA：只准备好 NFA 和字符等价类，不做子集构造，也没有 SDFA 可以生成程序，只能在进程内分析
+void MainWindow::on_btnLazyDfa_clicked() {
+    currState = lazyDfa;
+    resetQues01_SrcCodeLayout();
+    if(ui->inputText->toPlainText().isEmpty()){
+        QMessageBox::information(this,"解析文本错误","请输入文本内容");
+        return;
+    }
+    mQues01.parseExpressions(ui->inputText->toPlainText(), currState);
+    mBtnGenProgram->setEnabled(false);
+    mBtnTokenize->setEnabled(true);
+    mBtnBatch->setEnabled(true);
+    ui->statusbar->showMessage("按需构造 DFA：点击\"直接分析\"在扫描时构造状态");
+}
+
+void MainWindow::on_btnWordAnal_clicked(){
+    currState = nothing;
+    resetQues01_SrcCodeLayout();
+}
+
+// 重新设置 WordAnal 的表格布局
+void MainWindow::resetQues01_TableLayout() {
+    clearAnswer(ui->gridLayout_WordAnal);
+    // 生成 状态转换
+    mQues01.parseExpressions(ui->inputText->toPlainText(),currState);
+    mTransChars = mQues01.getTransChar();
+    // 新增 label 生成转换图按钮 和 表格视图
+    mTitle = new QLabel(QString("%1状态转换表：初态(绿)/终态(红)/初终态(黄)").arg(getStateStr()));
+    if(currState == dfa || currState == directDfa)    // 显示子集查找的命中和新建次数
+        mTitle->setText(mTitle->text() + QString("  子集查找：命中%1次/新建%2个")
+                        .arg(mQues01.getSubsetHits()).arg(mQues01.getSubsetCreated()));
+    if(mQues01.isDFAOverflow()) // 显示改用 NFA 模拟
+        mTitle->setText(mTitle->text() + "  DFA 超出预算，已改用位并行 NFA 模拟");
+    if(currState == directDfa)  // 显示位置的个数
+        mTitle->setText(mTitle->text() + QString("  位置：%1个").arg(mQues01.getPositionCount()));
+    mBtnGraph = new QPushButton(QString("生成%1转换图").arg(getStateStr()));
+    mAnsTable = new QTableWidget();
+    // 设置字体
+    mTitle->setFont(ChineseFont);
+    mBtnGraph->setFont(ChineseFont);
+
+    // 绑定信号和槽函数，展示图片
+    connect(mBtnGraph, SIGNAL(clicked()), this,SLOT(showGraph()));
+
+    // 设置布局
+    ui->gridLayout_WordAnal->addWidget(ui->GroupWord, 0, 0, 1, 8);
+    ui->gridLayout_WordAnal->addWidget(mTitle, 1, 0);
+    ui->gridLayout_WordAnal->addWidget(mBtnGraph, 1, 3, 1, 5);
+    ui->gridLayout_WordAnal->addWidget(mAnsTable, 2, 0, 1, 8);
+
+    // 设置行和列的伸展因子
+    ui->gridLayout_WordAnal->setRowStretch(0, 0);
+    ui->gridLayout_WordAnal->setRowStretch(1, 0);
+    ui->gridLayout_WordAnal->setRowStretch(2, 1);
+}
+
+// 重新设置 WordAnal 的表格布局
+void MainWindow::resetQues01_SrcCodeLayout() {
+    clearAnswer(ui->gridLayout_WordAnal);
+    // 新增标签、文本编辑器和按钮
+    mTitle = new QLabel("源程序");
+    mLabelTestCode = new QLabel("输入测试代码");
+    mLabelEncoding = new QLabel("单词编码输出");
+    mBtnGenProgram = new QPushButton("生成源程序");
+    mBtnRunProgram = new QPushButton("运行源程序");
+    mBtnTokenize = new QPushButton("直接分析");
+    mBtnRunLibrary = new QPushButton("加载共享库运行");
+    mBtnBatch = new QPushButton("批量分析");
+    mBtnGenHeader = new QPushButton("生成头文件");
+    mBtnOpenTestCode = new QPushButton("打开测试代码");
+    mBtnSaveEncoding = new QPushButton("保存单词编码");
+    mProgram = new QTextEdit();
+    mTestCode = new QTextEdit();
+    mEncoding = new QTextEdit();
+    mCheckNative = new QCheckBox("-march=native");
+    mCheckParallel = new QCheckBox("并行扫描");
+    mCheckPositions = new QCheckBox("行号列号");
+    mLabelCache = new QLabel();
+    // 设置字体
+    mTitle->setFont(ChineseFont);
+    mLabelTestCode->setFont(ChineseFont);
+    mLabelEncoding->setFont(ChineseFont);
+    mBtnGenProgram->setFont(ChineseFont);
+    mBtnRunProgram->setFont(ChineseFont);
+    mBtnTokenize->setFont(ChineseFont);
+    mBtnRunLibrary->setFont(ChineseFont);
+    mBtnBatch->setFont(ChineseFont);
+    mBtnGenHeader->setFont(ChineseFont);
+    mBtnOpenTestCode->setFont(ChineseFont);
+    mBtnSaveEncoding->setFont(ChineseFont);
+    mProgram->setFont(EnglishFont);
+    mTestCode->setFont(EnglishFont);
+    mEncoding->setFont(EnglishFont);
+    mCheckNative->setFont(EnglishFont);
+    mCheckParallel->setFont(ChineseFont);
+    mCheckPositions->setFont(ChineseFont);
+    mLabelCache->setFont(ChineseFont);
+
+    // 绑定信号和槽函数
+    connect(mBtnGenProgram, SIGNAL(clicked()), this, SLOT(getProgram()));
+    connect(mBtnRunProgram, SIGNAL(clicked()), this, SLOT(runProgram()));
+    connect(mBtnTokenize, SIGNAL(clicked()), this, SLOT(runTokenize()));
+    connect(mBtnRunLibrary, SIGNAL(clicked()), this, SLOT(runLibrary()));
+    connect(mBtnBatch, SIGNAL(clicked()), this, SLOT(runBatch()));
+    connect(mBtnGenHeader, SIGNAL(clicked()), this, SLOT(saveScannerHeader()));
+    connect(mBtnOpenTestCode, SIGNAL(clicked()), this, SLOT(openEncoding()));
+    connect(mBtnSaveEncoding, SIGNAL(clicked()), this, SLOT(saveEncoding()));
+    // 设置按钮不可点击
+    mBtnRunProgram->setEnabled(false);
+    mBtnTokenize->setEnabled(false);
+    mBtnRunLibrary->setEnabled(false);
+    mBtnBatch->setEnabled(false);
+    mBtnGenHeader->setEnabled(false);
+    mBtnSaveEncoding->setEnabled(false);
+
+    // 设置布局
+    ui->gridLayout_WordAnal->addWidget(ui->GroupWord, 0, 0, 1, 8);
+
+    ui->gridLayout_WordAnal->addWidget(mTitle, 1, 0);
+    ui->gridLayout_WordAnal->addWidget(mBtnGenProgram, 1, 1);
+    ui->gridLayout_WordAnal->addWidget(mLabelTestCode, 1, 2);
+    ui->gridLayout_WordAnal->addWidget(mBtnOpenTestCode, 1, 3);
+    ui->gridLayout_WordAnal->addWidget(mBtnRunProgram, 1, 4);
+    ui->gridLayout_WordAnal->addWidget(mBtnTokenize, 1, 5);
+    ui->gridLayout_WordAnal->addWidget(mLabelEncoding, 1, 6);
+    ui->gridLayout_WordAnal->addWidget(mBtnSaveEncoding, 1, 7);
+
+    ui->gridLayout_WordAnal->addWidget(mProgram, 2, 0, 1, 2);
+    ui->gridLayout_WordAnal->addWidget(mTestCode, 2, 2, 1, 4);
+    ui->gridLayout_WordAnal->addWidget(mEncoding, 2, 6, 1, 2);
+
+    ui->gridLayout_WordAnal->addWidget(mBtnBatch, 3, 0);
+    ui->gridLayout_WordAnal->addWidget(mBtnGenHeader, 3, 1);
+    ui->gridLayout_WordAnal->addWidget(mCheckParallel, 3, 2);
+    ui->gridLayout_WordAnal->addWidget(mCheckNative, 3, 3);
+    ui->gridLayout_WordAnal->addWidget(mBtnRunLibrary, 3, 4);
+    ui->gridLayout_WordAnal->addWidget(mCheckPositions, 3, 5);
+    ui->gridLayout_WordAnal->addWidget(mLabelCache, 3, 6, 1, 2);
+
+    // 设置行和列的伸展因子
+    ui->gridLayout_WordAnal->setRowStretch(0, 0);
+    ui->gridLayout_WordAnal->setRowStretch(1, 0);
+    ui->gridLayout_WordAnal->setRowStretch(2, 1);
+    ui->gridLayout_WordAnal->setRowStretch(3, 0);
+
+    ui->gridLayout_WordAnal->setColumnStretch(0, 0);
+    ui->gridLayout_WordAnal->setColumnStretch(1, 1);
+    ui->gridLayout_WordAnal->setColumnStretch(2, 0);
+    ui->gridLayout_WordAnal->setColumnStretch(3, 0);
+    ui->gridLayout_WordAnal->setColumnStretch(4, 0);
+    ui->gridLayout_WordAnal->setColumnStretch(5, 0);
+    ui->gridLayout_WordAnal->setColumnStretch(6, 0);
+    ui->gridLayout_WordAnal->setColumnStretch(7, 1);
+}
+
+// 显示 WordAnal 状态转换表 的数据
+void MainWindow::setTable() {
+    QStringList header;
+    // 设置列标签
+    header << "初态/终态"<< "状态编号" << "变量名";
+    for (auto & ch : mTransChars)
+        if(ch[0] == '\\')
+            header << ch.mid(1);
+        else
+            header << ch;
+    mAnsTable->setColumnCount(mTransChars.size() + 3);     // 设定列的数量
+    mAnsTable->setHorizontalHeaderLabels(header);    // 设定列名
+    mAnsTable->verticalHeader()->setVisible(false);  // 隐藏行号
+    mAnsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);  // 单元格内容不可编辑
+
+    //逐行更新item
+    for (auto & tmp : mNodes) {
+        size_t i = tmp->getStateID();
+        mAnsTable->insertRow(mAnsTable->rowCount());
+
+        //第一列 -初态(绿) / +终态(红) / +-初终态(黄)
+        if (tmp->getIsStart() && tmp->getIsEnd()) {
+            mAnsTable->setItem(i, 0, new QTableWidgetItem(QString("+-")));
+            mAnsTable->item(i, 0)->setBackground(
+                QBrush(QColor(255, 255, 0)));  //黄色
+        } else if (tmp->getIsStart()) {
+            mAnsTable->setItem(i, 0, new QTableWidgetItem(QString("-")));
+            mAnsTable->item(i, 0)->setBackground(
+                QBrush(QColor(0, 255, 0)));  //绿色
+        } else if (tmp->getIsEnd()) {
+            mAnsTable->setItem(i, 0, new QTableWidgetItem(QString("+")));
+            mAnsTable->item(i, 0)->setBackground(
+                QBrush(QColor(255, 0, 0)));  //红色
+        }
+
+        // 第二列 node 编号
+        QString itemStr = QString::number(i);
+        mAnsTable->setItem(i, 1, new QTableWidgetItem(itemStr));
+
+        // 第三列 node 内容
+        if(tmp->getVarName()!="")
+            mAnsTable->setItem(i, 2, new QTableWidgetItem(tmp->getVarName()));
+
+        //第四列 及之后
+        int col = 3;
+        for (auto & ch:mTransChars) {
+            set<size_t> res = tmp->getTrans(ch);
+            if (res.size())
+                mAnsTable->setItem(i, col, new QTableWidgetItem(setTOstr(res)));
+            col++;
+        }  // end for
+    }   // end for table cols
+    mAnsTable->resizeColumnsToContents();// 根据内容来确定列宽度
+}
+
+void MainWindow::showGraph() {
+    QDir tmpDir(QDir::currentPath() + "/tmp");
+    if (!tmpDir.exists())
+        tmpDir.mkpath(".");
+
+    // 指定 DOT 暂存文件的路径和名称
+    QString fileName = QDir::currentPath() + "/tmp/" + getStateStr();
+
+    // 将 DOT 代码写入暂存文件中
+    QFile dotFile(fileName + ".dot");
+    if (dotFile.open(QIODevice::WriteOnly)) {
+        dotFile.write(genDotFile());
+        dotFile.close();
+        // 调用 Graphviz 命令生成图像文件
+        QString cmd = QString("dot -Gcharset=utf8 -Tsvg -o \"%1.svg\" \"%2.dot\" ").arg(fileName).arg(fileName);
+        QProcess::execute(cmd);
+        // 打开默认设备，显示生成的图像
+        QDesktopServices::openUrl(QUrl::fromLocalFile(fileName + ".svg"));
+    }
+}
+
+void MainWindow::getProgram() {
+    resetQues01_SrcCodeLayout();
+//    如果规则文本为空，提示输入文本内容
+    if(ui->inputText->toPlainText().isEmpty()){
+        QMessageBox::information(this,"解析文本错误","请输入文本内容");
+        return;
+    }
+    // 生成状态转换
+    mQues01.parseExpressions(ui->inputText->toPlainText(), currState);
+    // DFA 超出预算时没有 SDFA，不能生成程序，但仍然可以在进程内分析
+    mBtnTokenize->setEnabled(true);
+    mBtnBatch->setEnabled(true);
+    if(mQues01.getSDFAstates().empty())
+        QMessageBox::information(this,"解析文本错误","得到的 SDFA 数组为空");
+
+    QDir tmpDir(QDir::currentPath() + "/tmp");
+    if (!tmpDir.exists())
+        tmpDir.mkpath(".");
+
+    QFile file(QDir::currentPath() + "/tmp/WordAnal_Program.cpp");
+    QString program;
+//    写入文件
+    if(file.open(QIODevice::WriteOnly | QIODevice::Text)){
+        QTextStream text(&file);
+        mQues01.genProgram(text);// 写入文件
+        file.close();
+    } else
+        QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
+
+//    读取文件
+    if(file.open(QIODevice::ReadOnly | QIODevice::Text)){
+        QTextStream text(&file);
+        program = text.readAll();// 读取文件
+        file.close();
+    } else
+        QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
+    mProgram->setText("");
+    if(program != ""){
+        mProgram->setText(program);
+        mBtnRunProgram->setEnabled(true);
+        mBtnRunLibrary->setEnabled(true);
+        mBtnGenHeader->setEnabled(true);
+    }
+    else
+        QMessageBox::information(this,"解析文本错误","得到的 SDFA 数组为空");
+}
+
+void MainWindow::runProgram() {
+    // 准备输入的测试文件
+    QString inFileName = "Word.in";
+    QString outFileName = "Word.out";
+    QString inFilePath = QDir::currentPath() + "/tmp/" + inFileName;
+    QString outFilePath = QDir::currentPath() + "/tmp/" + outFileName;
+    QFile file(inFilePath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream text(&file);
+        text << mTestCode->toPlainText(); // 写入文件
+        file.close();
+    } else {
+        QMessageBox::information(this, "Failed to Open Input File!", "Failed to open file for writing!");
+        return;
+    }
+
+    // 编译程序，源程序和编译选项都没有变化时直接使用缓存的可执行文件
+    QString programPath = QDir::currentPath() + "/tmp/WordAnal_Program.cpp";
+    bool hit = false;
+    QString execPath = compileProgram(programPath, hit);
+    if (execPath.isEmpty())
+        return;
+    mLabelCache->setText(hit ? "编译缓存：命中" : "编译缓存：未命中，已编译并加入缓存");
+
+    // 运行程序
+    QProcess process2;
+    process2.setWorkingDirectory(QDir::currentPath() + "/tmp");
+    process2.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    QStringList args;
+    if (mCheckPositions->isChecked())
+        args << "-l";
+    process2.start(execPath, args << inFilePath << outFilePath);
+    if (!process2.waitForFinished()) {
+        QMessageBox::information(this, "Run Error!", "Failed to run the program: " + process2.errorString());
+        return;
+    }
+
+    // 读入文件并显示文本
+    QFile file2(outFilePath);
+    if (file2.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream text(&file2);
+        mEncoding->setText(text.readAll());
+        file2.close();
+        mBtnSaveEncoding->setEnabled(true);
+    } else {
+        QMessageBox::information(this, "Failed to Open Output File!", "Failed to open file for reading!");
+        return;
+    }
+}
+
+/**
+ * @brief 编译生成的源程序，编译结果按内容缓存
+ * @param programPath 源程序的路径
+ * @param [out] hit 是否命中缓存
+ * @param sharedLibrary 编译为共享库（.dll / .so）而不是可执行文件
+ * @return 可执行文件或共享库的路径，编译失败返回空字符串
+ * @note 编译器为 g++，生成的程序带批量扫描的 main（BatchMain）时使用 std::thread，所以总是加上 -pthread。
+ * 缓存目录为 tmp/cache，文件名为 编译器、编译选项和源程序内容的 SHA-1，
+ * 命中时不再编译，只更新文件的修改时间；未命中时编译到缓存目录，
+ * 编译失败的文件不会留在缓存中。加入新文件后按修改时间淘汰最久没有使用的文件，
+ * 使缓存的总大小不超过 ProgramCacheBytes。已经加载的共享库在 Windows 上删除失败时留到下一次淘汰。
+ */
+QString MainWindow::compileProgram(const QString& programPath, bool& hit, bool sharedLibrary) {
+    QString compiler = "g++";
+    QStringList flags;
+    flags << "-O2" << "-pthread";
+    if (mCheckNative->isChecked())
+        flags << "-march=native";
+    QString suffix = ".exe";
+    if (sharedLibrary) {
+        flags << "-shared";
+#ifdef Q_OS_WIN
+        suffix = ".dll";
+#else
+        flags << "-fPIC";
+        suffix = ".so";
+#endif
+    }
+
+    QFile source(programPath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        QMessageBox::information(this, "Compile Error!", "Failed to open the program: " + programPath);
+        return "";
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData((compiler + " " + flags.join(" ") + "\n").toUtf8());
+    hash.addData(source.readAll());
+    source.close();
+
+    QDir cacheDir(QDir::currentPath() + "/tmp/cache");
+    if (!cacheDir.exists())
+        cacheDir.mkpath(".");
+    QString execName = QString(hash.result().toHex()) + suffix;
+    QString execPath = cacheDir.filePath(execName);
+
+    hit = QFile::exists(execPath);
+    if (hit) {
+        // 更新修改时间，作为最近使用的记录
+        QFile exec(execPath);
+        if (exec.open(QIODevice::ReadWrite)) {
+            exec.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+            exec.close();
+        }
+        return execPath;
+    }
+
+    QProcess process1;
+    process1.setWorkingDirectory(QDir::currentPath() + "/tmp");
+    process1.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    process1.start(compiler, QStringList() << flags << "-o" << execPath << programPath);
+    if (!process1.waitForFinished(-1) || process1.exitStatus() != QProcess::NormalExit || process1.exitCode() != 0) {
+        QFile::remove(execPath);
+        QMessageBox::information(this, "Compile Error!", "Failed to compile the program: " + process1.readAllStandardError());
+        return "";
+    }
+    trimProgramCache(cacheDir, execName);
+    return execPath;
+}
+
+/**
+ * @brief 淘汰缓存中最久没有使用的可执行文件
+ * @param cacheDir 缓存目录
+ * @param keep 刚刚使用的文件，不会被淘汰
+ */
+void MainWindow::trimProgramCache(const QDir& cacheDir, const QString& keep) {
+    // 按修改时间从新到旧排列
+    QFileInfoList files = cacheDir.entryInfoList(QStringList() << "*.exe" << "*.dll" << "*.so", QDir::Files, QDir::Time);
+    qint64 total = 0;
+    for (auto & info : files) {
+        total += info.size();
+        if (total > ProgramCacheBytes && info.fileName() != keep)
+            QFile::remove(info.absoluteFilePath());
+    }
+}
+
+// 不生成和编译程序，直接用已构造的自动机对测试代码进行词法分析
+void MainWindow::runTokenize() {
+    QByteArray input = mTestCode->toPlainText().toUtf8();
+    vector<LexToken> tokens;
+    QElapsedTimer timer;
+    timer.start();
+    LazyDFAStats lazy = {0, 0, 0, 0};
+    mQues01.tokenize(input.constData(), size_t(input.size()), tokens, scanThreads(), &lazy);
+    qint64 elapsed = timer.elapsed();
+
+    setLexResult(input, tokens);
+    QString message = QString("进程内词法分析：%1 个单词，用时 %2 ms，%3 个线程")
+            .arg(tokens.size()).arg(elapsed).arg(scanThreads());
+    if (currState == lazyDfa)   // 按需构造的 DFA 总是在一个线程中扫描
+        message = QString("按需构造 DFA：%1 个单词，用时 %2 ms，转移命中 %3 次/未命中 %4 次，清空缓存 %5 次，%6 个状态")
+                .arg(tokens.size()).arg(elapsed).arg(lazy.hits).arg(lazy.misses).arg(lazy.flushes).arg(lazy.states);
+    ui->statusbar->showMessage(message);
+}
+
+// 生成共享库形式的扫描程序，编译（命中缓存时跳过）并加载到进程中，直接调用它对测试代码进行词法分析
+void MainWindow::runLibrary() {
+    QDir tmpDir(QDir::currentPath() + "/tmp");
+    if (!tmpDir.exists())
+        tmpDir.mkpath(".");
+    QString programPath = QDir::currentPath() + "/tmp/WordAnal_Library.cpp";
+    QFile file(programPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream text(&file);
+        mQues01.genProgram(text, true);
+        file.close();
+    } else {
+        QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
+        return;
+    }
+
+    bool hit = false;
+    QString libraryPath = compileProgram(programPath, hit, true);
+    if (libraryPath.isEmpty())
+        return;
+    mLabelCache->setText(hit ? "编译缓存：命中" : "编译缓存：未命中，已编译并加入缓存");
+    if (!mScanner.load(libraryPath)) {
+        QMessageBox::information(this, "Load Error!", "Failed to load the library: " + mScanner.errorString());
+        return;
+    }
+    if (mScanner.getRuleCount() != int(mQues01.getRuleNames().size())) {
+        QMessageBox::information(this, "Load Error!", "The library does not match the current rules!");
+        return;
+    }
+
+    QByteArray input = mTestCode->toPlainText().toUtf8();
+    vector<LexToken> tokens;
+    QElapsedTimer timer;
+    timer.start();
+    mScanner.scan(input.constData(), size_t(input.size()), tokens, scanThreads());
+    qint64 elapsed = timer.elapsed();
+    setLexResult(input, tokens);
+    ui->statusbar->showMessage(QString("共享库词法分析：%1 个单词，用时 %2 ms，%3 个线程")
+                               .arg(tokens.size()).arg(elapsed).arg(scanThreads()));
+}
+
+// 直接分析和共享库扫描使用的线程数：勾选并行扫描时为硬件的线程数，输入太小时仍然只用一个线程
+unsigned MainWindow::scanThreads() const {
+    return mCheckParallel->isChecked() ? unsigned(max(QThread::idealThreadCount(), 1)) : 1u;
+}
+
+/**
+ * @brief 批量词法分析：选择一个目录，在线程池中用进程内的词法分析扫描其中（包括子目录）所有的文件，
+ * 结果合并为一个带索引的文件（WordAnal::tokenizeFiles），状态栏显示总的吞吐量
+ * @note 线程数由"并行扫描"决定；输出文件在这个目录中时不扫描它
+ */
+void MainWindow::runBatch() {
+    QString dirName = QFileDialog::getExistingDirectory(this, "选择要批量分析的目录", "../test_data");
+    if (dirName.isEmpty())
+        return;
+    QString outPath = QFileDialog::getSaveFileName(this, "批量分析结果保存至文件", "../test_data/batch.lex", "");
+    if (outPath.isEmpty()) {
+        QMessageBox::information(this, "Failed to Save File!", "File name is Empty!");
+        return;
+    }
+    QString outAbsolute = QFileInfo(outPath).absoluteFilePath();
+    QStringList files;
+    QDirIterator it(dirName, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        if (QFileInfo(path).absoluteFilePath() != outAbsolute)
+            files << path;
+    }
+    files.sort();
+    if (files.isEmpty()) {
+        QMessageBox::information(this, "批量分析", "目录中没有文件");
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    LexBatchStats stats = mQues01.tokenizeFiles(files, outPath, scanThreads());
+    qint64 elapsed = timer.elapsed();
+    double megabytes = double(stats.bytes) / 1e6;
+    ui->statusbar->showMessage(QString("批量词法分析：%1 个文件（%2 个出错），%3 MB，用时 %4 ms，%5 MB/s，%6 个线程")
+                               .arg(stats.files).arg(stats.failed).arg(megabytes, 0, 'f', 1).arg(elapsed)
+                               .arg(elapsed > 0 ? megabytes * 1000 / elapsed : 0.0, 0, 'f', 1).arg(scanThreads()));
+}
+
+// 显示进程内词法分析的结果，同时保留带行号和列号的记号数组，语法分析时不必再从文本中解析
+void MainWindow::setLexResult(const QByteArray& input, const vector<LexToken>& tokens) {
+    QString encoding;
+    QTextStream text(&encoding);
+    mQues01.writeTokens(text, input.constData(), tokens, mCheckPositions->isChecked());
+    text.flush();
+    mEncoding->setText(encoding);
+    mBtnSaveEncoding->setEnabled(true);
+
+    mLexStreamPath.clear();
+    mLexTokens.clear();
+    LexLineCounter lines(input.constData());
+    for (auto & tok : tokens) {
+        QString type = mQues01.tokenType(input.constData(), tok);
+        if (type.isEmpty())
+            continue;
+        LexPosition at = lines.at(tok.offset);
+        mLexTokens.push_back(Token(type, QString::fromUtf8(input.constData() + tok.offset, int(tok.length)), at.line, at.column));
+    }
+}
+
+// 生成只有头文件的可重入词法分析器，保存到文件并显示在源程序区域
+void MainWindow::saveScannerHeader() {
+    QString fileName = QFileDialog::getSaveFileName(this, "词法分析器头文件保存至文件", "../test_data/lex_scanner.h", "");
+    if (fileName.isEmpty()) {
+        QMessageBox::information(this, "Failed to Save File!", "File name is Empty!");
+        return;
+    }
+    QString header;
+    QTextStream text(&header);
+    mQues01.genScannerHeader(text);
+    text.flush();
+    QFile file(fileName);
+    QByteArray bytes = header.toUtf8();
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(bytes, bytes.length());
+        file.close();
+        mProgram->setText(header);
+    } else
+        QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
+}
+
+// 保存单词编码；文件名以 .lexb 结尾时对测试代码进行进程内词法分析，保存为二进制单词流
+void MainWindow::saveEncoding() {
+   QString fileName = QFileDialog::getSaveFileName(this, "单词编码保存至文件", "../test_data", "");
+   if (!fileName.isEmpty()) {
+       QFile file(fileName);
+       QByteArray text = mEncoding->toPlainText().toUtf8();
+       if (fileName.endsWith(".lexb")) {
+           if (!mBtnTokenize->isEnabled()) {
+               QMessageBox::information(this, "Failed to Save File!", "请先生成自动机");
+               return;
+           }
+           QByteArray input = mTestCode->toPlainText().toUtf8();
+           vector<LexToken> tokens;
+           mQues01.tokenize(input.constData(), size_t(input.size()), tokens, scanThreads());
+           text = mQues01.tokenStream(input.constData(), size_t(input.size()), tokens, true);
+       }
+       if (file.open(QIODevice::WriteOnly)) {
+           file.write(text, text.length());
+           file.close();
+           QMessageBox::information(this, "File Saved!", "File has been saved successfully!");
+       } else
+           QMessageBox::information(this, "Failed to Save File!", "Failed to open file for writing!");
+   } else
+       QMessageBox::information(this, "Failed to Save File!", "File name is Empty!");
+}
+
+void MainWindow::openEncoding() {
+    QString fileName = QFileDialog::getOpenFileName(this, "打开测试代码文件", "../test_data", "");
+    if (!fileName.isEmpty()) {
+        QFile file(fileName);
+        if(file.open(QIODevice::ReadOnly)){
+            mTestCode->setText(file.readAll());
+            file.close();
+        } else
+            QMessageBox::information(this, "Failed to Read File!", "Maybe the file not exist!");
+    } else
+        QMessageBox::information(this, "Failed to Open File!", "File name is Empty!");
+}
+
+// 由于需要使用UTF8编码，所以返回二进制格式 QByteArray
+QByteArray MainWindow::genDotFile() {
+    QByteArray output;
+    // 文件头部
+    output += "digraph " + getStateStr() + " {\n";
+    output += "\t rankdir=LR;\n ";
+    output += "\t node [fontname=\"Consolas\", shape = ellipse];\n";
+    output += "\t edge [fontname=\"Consolas\"];\n";
+
+    // 添加节点
+    for (int i = 0; i < mAnsTable->rowCount(); i++) {
+        output += QString("\ts%1").arg(i) + " [style=filled, ";
+        QTableWidgetItem *item = mAnsTable->item(i, 0);
+        if(item != nullptr && !item->text().isEmpty()){
+            if (item->text() == "+"){
+                // 终态，红色
+                output += "peripheries=2, color=red, label=\""
+                        + mAnsTable->item(i, 1)->text() + "\\n"
+                        +  mAnsTable->item(i, 2)->text()  + "\"];\n";
+            }
+            else if (item->text() == "-") // 初态，绿色
+                output += "color=green, label=\"" + mAnsTable->item(i, 1)->text() + "\"];\n";
+            else // 初终态，黄色
+                output += "peripheries=2, color=yellow, label=\""
+                        + mAnsTable->item(i, 1)->text() + "\\n"
+                        + mAnsTable->item(i, 2)->text()  + "\"];\n";
+        } else
+            output += "label=\"" + mAnsTable->item(i, 1)->text() + "\"];\n";
+    }
+
+    // 添加边
+    for (int from = 0; from < mAnsTable->rowCount(); from++)
+        for (int to = 3; to < mAnsTable->columnCount(); to++)
+            if (mAnsTable->item(from, to) != nullptr) {
+                QString label = mAnsTable->horizontalHeaderItem(to)->text();
+                QString edgeId = QString("e%1_%2").arg(from).arg(to);
+                QString fromId = QString("s%1").arg(from);
+
+                QString toSet = mAnsTable->item(from, to)->text();
+                toSet = toSet.mid(1,toSet.size()-2);
+                QStringList toList = toSet.split(",");
+                for(auto & toText :toList ){
+                    QString toId = QString("s%1").arg(toText);
+                    output += QString("\t%1 -> %2 [label=\"").arg(fromId).arg(toId);
+                    output += label.toUtf8() + "\"];\n";
+                }
+            }
+    output += "}\n";
+    return output;
+}